@@ -0,0 +1,154 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+/*
+  ==============================================================================
+
+    DSPAnalysis.cpp
+
+  ==============================================================================
+*/
+
+#include "DSPAnalysis.h"
+#include <math.h>
+#include <string.h>
+
+DSPAnalysis::DSPAnalysis(int Nfft, int Nchannels, int Ncopy, int window_type,
+    double rate)
+    :
+    Nfft(Nfft),
+    Nchannels(Nchannels),
+    Ncopy(Ncopy),
+    window_type(window_type)
+{
+    Npoints = Nfft/2 + 1;
+    Ncount = Nfft/Ncopy;
+    int Ndisplay = (int)ceil(rate/SPECTRA_RATE);
+    if(Ncount < Ndisplay)
+        Ncount = Ndisplay;
+    count = Ncount;
+    i_sample = 0;
+    Npoints_out = 0;
+    ready = false;
+
+    fft.reset(new FFT(Nfft, Nchannels));
+    window.reset(new FFTWindow((WindowType)window_type, Nfft));
+    x_cyclic.reset(new float[Nfft*Nchannels]);
+    x.reset(new float[Nfft*Nchannels]);
+    X_pow.reset(new float[Npoints*Nchannels]);
+    spectra.reset(new uint16_t[SPECTRA_POINTS_MAX*Nchannels]);
+    envelope.reset(new float[SPECTRA_ENVELOPE_POINTS*2*Nchannels]);
+    memset(x_cyclic.get(), 0, sizeof(float)*Nfft*Nchannels);
+}
+
+DSPAnalysis::~DSPAnalysis(void)
+{
+}
+
+void DSPAnalysis::Process(const float * const *in, uint32_t n)
+{
+    uint32_t offset = 0;
+    while(n>0){
+        uint32_t m = Nfft - i_sample;
+        if(n < m) m = n;
+        for(int c=0;c<Nchannels;c++)
+            memcpy(&x_cyclic[c*Nfft + i_sample], in[c] + offset,
+                sizeof(float)*m);
+        offset += m;
+        n -= m;
+        i_sample += m;
+        if(i_sample==Nfft)
+            i_sample = 0;
+        count -= m;
+    }
+    if(count<=0){
+        // hops missed within a block are skipped, only the latest
+        // spectrum is sent
+        count = Ncount - (-count % Ncount);
+        ready = true;
+    }
+}
+
+int DSPAnalysis::Compute(int max_points)
+{
+    ready = false;
+
+    // linearize the cyclic buffers, oldest sample first
+    int N1 = Nfft - i_sample;
+    int N2 = i_sample;
+    for(int c=0;c<Nchannels;c++){
+        memcpy(&x[c*Nfft], &x_cyclic[c*Nfft + i_sample], sizeof(float)*N1);
+        memcpy(&x[c*Nfft + N1], &x_cyclic[c*Nfft], sizeof(float)*N2);
+    }
+
+    fft->ExecutePairs(window.get(), x.get());
+    fft->PowerSpectrumPairs(X_pow.get());
+
+    if(max_points > SPECTRA_POINTS_MAX)
+        max_points = SPECTRA_POINTS_MAX;
+    int D = 1;
+    while((Npoints-2)/D + 2 > max_points && D < Nfft/2)
+        D <<= 1;
+    Npoints_out = (Npoints-2)/D + 2;
+
+    float norm = 2.0f/window->GetCoherentGain()/Nfft;
+    for(int c=0;c<Nchannels;c++){
+        Quantize(&X_pow[c*Npoints], norm*norm, D, &spectra[c*Npoints_out]);
+        Envelope(&x[c*Nfft], &envelope[c*SPECTRA_ENVELOPE_POINTS*2]);
+    }
+
+    return Npoints_out;
+}
+
+void DSPAnalysis::Quantize(const float *X_pow, float norm2, int D, uint16_t *q)
+{
+    // the peak of each group of D bins, see SpectraFormat.h
+    float p = X_pow[0];
+    int j = 0;
+    for(int k=0;k<Npoints;k++){
+        int jk = spectra_decimated_index(k, D);
+        if(jk!=j){
+            float pow_X = p*norm2;
+            if(pow_X < 1e-18f) pow_X = 1e-18f;
+            q[j] = spectra_quantize(10.0f*log10f(pow_X));
+            j = jk;
+            p = X_pow[k];
+        }else if(X_pow[k] > p){
+            p = X_pow[k];
+        }
+    }
+    float pow_X = p*norm2;
+    if(pow_X < 1e-18f) pow_X = 1e-18f;
+    q[j] = spectra_quantize(10.0f*log10f(pow_X));
+}
+
+void DSPAnalysis::Envelope(const float *x, float *env)
+{
+    for(int p=0;p<SPECTRA_ENVELOPE_POINTS;p++){
+        int i0 = (int)((int64_t)p*Nfft/SPECTRA_ENVELOPE_POINTS);
+        int i1 = (int)((int64_t)(p+1)*Nfft/SPECTRA_ENVELOPE_POINTS);
+        float v_min = x[i0];
+        float v_max = x[i0];
+        for(int i=i0+1;i<i1;i++){
+            if(x[i] < v_min) v_min = x[i];
+            if(x[i] > v_max) v_max = x[i];
+        }
+        env[p*2] = v_min;
+        env[p*2+1] = v_max;
+    }
+}
@@ -0,0 +1,92 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+/*
+  ==============================================================================
+
+    DSPAnalysis.h
+
+    Spectrum analysis run in the plugin. Samples are gathered in run()
+    and at most one spectrum per hop is computed, the hop being the
+    larger of Nfft/Ncopy and one display frame. The result is stored in
+    the Spectra wire format so that only display rate data crosses the
+    notify port.
+
+    Construction allocates and plans, so it must happen off the audio
+    thread. Process and Compute do not allocate.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <memory>
+#include <stdint.h>
+#include "FFT.h"
+#include "FFTWindow.h"
+#include "SpectraFormat.h"
+
+class DSPAnalysis
+{
+    int Nfft;
+    int Nchannels;
+    int Ncopy;
+    int window_type;
+    int Npoints;
+    int Ncount;
+    int count;
+    int i_sample;
+    int Npoints_out;
+    bool ready;
+    std::unique_ptr<FFT> fft;
+    std::unique_ptr<FFTWindow> window;
+    // Nfft samples and Npoints bins per channel, channel-major
+    std::unique_ptr<float[]> x_cyclic;
+    std::unique_ptr<float[]> x;
+    std::unique_ptr<float[]> X_pow;
+    std::unique_ptr<uint16_t[]> spectra;
+    std::unique_ptr<float[]> envelope;
+
+    void Quantize(const float *X_pow, float norm2, int D, uint16_t *q);
+    void Envelope(const float *x, float *env);
+
+public:
+    DSPAnalysis(int Nfft, int Nchannels, int Ncopy, int window_type,
+        double rate);
+    ~DSPAnalysis(void);
+
+    bool Matches(int Nfft, int Ncopy, int window_type)
+    {
+        return Nfft==DSPAnalysis::Nfft
+            && Ncopy==DSPAnalysis::Ncopy
+            && window_type==DSPAnalysis::window_type;
+    }
+
+    // gather n samples of each of the Nchannels inputs
+    void Process(const float * const *in, uint32_t n);
+    // true when a hop has elapsed since the last Compute
+    bool IsReady(void) { return ready; }
+    // analyse the last Nfft samples with at most max_points values
+    // per channel, returns the number of values per channel
+    int Compute(int max_points);
+
+    int GetNumChannels(void) { return Nchannels; }
+    int GetNumPoints(void) { return Npoints_out; }
+    const uint16_t* GetSpectra(void) { return spectra.get(); }
+    const float* GetEnvelope(void) { return envelope.get(); }
+};
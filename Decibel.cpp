@@ -0,0 +1,321 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+/*
+  ==============================================================================
+
+    Decibel.cpp
+
+  ==============================================================================
+*/
+
+#include "Decibel.h"
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// 10*log10(2)
+#define DB_PER_OCTAVE 3.01029995663981f
+// bits of sqrt(1/2), the bottom of the reduced mantissa range
+#define SQRT_HALF_BITS 0x3f3504f3
+
+// log2(1+f) ~ f*(C1 + f*(C2 + f*(C3 + f*(C4 + f*C5)))) on
+// [sqrt(1/2)-1, sqrt(2)-1], weighted least squares, |error| < 1.5e-5
+#define C1  1.44257802f
+#define C2 -0.72024163f
+#define C3  0.48668709f
+#define C4 -0.39457582f
+#define C5  0.25265156f
+
+static inline float decibel(float p)
+{
+    if(!(p > DECIBEL_POWER_MIN)) p = DECIBEL_POWER_MIN;
+    uint32_t bits;
+    memcpy(&bits, &p, sizeof(bits));
+    int32_t e = (int32_t)(bits - SQRT_HALF_BITS) >> 23;
+    bits -= (uint32_t)e << 23;
+    float m;
+    memcpy(&m, &bits, sizeof(m));
+    float f = m - 1.0f;
+    float l = f*(C1 + f*(C2 + f*(C3 + f*(C4 + f*C5))));
+    return ((float)e + l)*DB_PER_OCTAVE;
+}
+
+static void power_db_scalar(const float *P, float *dB, size_t n, float norm2)
+{
+    for(size_t i=0;i<n;i++)
+        dB[i] = decibel(P[i]*norm2);
+}
+
+static void complex_db_scalar(const float *X, float *dB, size_t n, float norm2)
+{
+    for(size_t i=0;i<n;i++){
+        float re = X[2*i];
+        float im = X[2*i+1];
+        dB[i] = decibel((re*re + im*im)*norm2);
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+static inline __m128 decibel_sse2(__m128 p)
+{
+    // max_ps returns the second operand for a NaN, so NaN goes to the floor
+    p = _mm_max_ps(p, _mm_set1_ps(DECIBEL_POWER_MIN));
+    __m128i bits = _mm_castps_si128(p);
+    __m128i e = _mm_srai_epi32(
+        _mm_sub_epi32(bits, _mm_set1_epi32(SQRT_HALF_BITS)), 23);
+    __m128 m = _mm_castsi128_ps(_mm_sub_epi32(bits, _mm_slli_epi32(e, 23)));
+    __m128 f = _mm_sub_ps(m, _mm_set1_ps(1.0f));
+    __m128 l = _mm_set1_ps(C5);
+    l = _mm_add_ps(_mm_mul_ps(l, f), _mm_set1_ps(C4));
+    l = _mm_add_ps(_mm_mul_ps(l, f), _mm_set1_ps(C3));
+    l = _mm_add_ps(_mm_mul_ps(l, f), _mm_set1_ps(C2));
+    l = _mm_add_ps(_mm_mul_ps(l, f), _mm_set1_ps(C1));
+    l = _mm_mul_ps(l, f);
+    return _mm_mul_ps(_mm_add_ps(_mm_cvtepi32_ps(e), l),
+        _mm_set1_ps(DB_PER_OCTAVE));
+}
+
+static void power_db_sse2(const float *P, float *dB, size_t n, float norm2)
+{
+    const __m128 vnorm = _mm_set1_ps(norm2);
+    size_t i = 0;
+    for(;i+4<=n;i+=4){
+        __m128 p = _mm_mul_ps(_mm_loadu_ps(P + i), vnorm);
+        _mm_storeu_ps(dB + i, decibel_sse2(p));
+    }
+    power_db_scalar(P + i, dB + i, n - i, norm2);
+}
+
+static void complex_db_sse2(const float *X, float *dB, size_t n, float norm2)
+{
+    const __m128 vnorm = _mm_set1_ps(norm2);
+    size_t i = 0;
+    for(;i+4<=n;i+=4){
+        __m128 a = _mm_loadu_ps(X + 2*i);
+        __m128 b = _mm_loadu_ps(X + 2*i + 4);
+        a = _mm_mul_ps(a, a);
+        b = _mm_mul_ps(b, b);
+        __m128 p = _mm_add_ps(
+            _mm_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0)),
+            _mm_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1)));
+        _mm_storeu_ps(dB + i, decibel_sse2(_mm_mul_ps(p, vnorm)));
+    }
+    complex_db_scalar(X + 2*i, dB + i, n - i, norm2);
+}
+
+__attribute__((target("avx2,fma")))
+static inline __m256 decibel_avx2(__m256 p)
+{
+    p = _mm256_max_ps(p, _mm256_set1_ps(DECIBEL_POWER_MIN));
+    __m256i bits = _mm256_castps_si256(p);
+    __m256i e = _mm256_srai_epi32(
+        _mm256_sub_epi32(bits, _mm256_set1_epi32(SQRT_HALF_BITS)), 23);
+    __m256 m = _mm256_castsi256_ps(
+        _mm256_sub_epi32(bits, _mm256_slli_epi32(e, 23)));
+    __m256 f = _mm256_sub_ps(m, _mm256_set1_ps(1.0f));
+    __m256 l = _mm256_set1_ps(C5);
+    l = _mm256_fmadd_ps(l, f, _mm256_set1_ps(C4));
+    l = _mm256_fmadd_ps(l, f, _mm256_set1_ps(C3));
+    l = _mm256_fmadd_ps(l, f, _mm256_set1_ps(C2));
+    l = _mm256_fmadd_ps(l, f, _mm256_set1_ps(C1));
+    return _mm256_mul_ps(_mm256_fmadd_ps(l, f, _mm256_cvtepi32_ps(e)),
+        _mm256_set1_ps(DB_PER_OCTAVE));
+}
+
+__attribute__((target("avx2,fma")))
+static void power_db_avx2(const float *P, float *dB, size_t n, float norm2)
+{
+    const __m256 vnorm = _mm256_set1_ps(norm2);
+    size_t i = 0;
+    for(;i+8<=n;i+=8){
+        __m256 p = _mm256_mul_ps(_mm256_loadu_ps(P + i), vnorm);
+        _mm256_storeu_ps(dB + i, decibel_avx2(p));
+    }
+    // the tail and the caller run SSE code, avoid the transition penalty
+    _mm256_zeroupper();
+    power_db_scalar(P + i, dB + i, n - i, norm2);
+}
+
+__attribute__((target("avx2,fma")))
+static void complex_db_avx2(const float *X, float *dB, size_t n, float norm2)
+{
+    const __m256 vnorm = _mm256_set1_ps(norm2);
+    size_t i = 0;
+    for(;i+8<=n;i+=8){
+        __m256 a = _mm256_loadu_ps(X + 2*i);
+        __m256 b = _mm256_loadu_ps(X + 2*i + 8);
+        // hadd works within 128 bit lanes, giving bins 0 1 4 5 2 3 6 7
+        __m256 p = _mm256_hadd_ps(_mm256_mul_ps(a, a), _mm256_mul_ps(b, b));
+        p = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(p),
+            _MM_SHUFFLE(3,1,2,0)));
+        _mm256_storeu_ps(dB + i, decibel_avx2(_mm256_mul_ps(p, vnorm)));
+    }
+    _mm256_zeroupper();
+    complex_db_scalar(X + 2*i, dB + i, n - i, norm2);
+}
+
+static bool have_avx2(void)
+{
+    static const bool avx2 = __builtin_cpu_supports("avx2")
+        && __builtin_cpu_supports("fma");
+    return avx2;
+}
+#elif defined(__aarch64__)
+static inline float32x4_t decibel_neon(float32x4_t p)
+{
+    p = vmaxq_f32(p, vdupq_n_f32(DECIBEL_POWER_MIN));
+    int32x4_t bits = vreinterpretq_s32_f32(p);
+    int32x4_t e = vshrq_n_s32(
+        vsubq_s32(bits, vdupq_n_s32(SQRT_HALF_BITS)), 23);
+    float32x4_t m = vreinterpretq_f32_s32(vsubq_s32(bits, vshlq_n_s32(e, 23)));
+    float32x4_t f = vsubq_f32(m, vdupq_n_f32(1.0f));
+    float32x4_t l = vdupq_n_f32(C5);
+    l = vfmaq_f32(vdupq_n_f32(C4), l, f);
+    l = vfmaq_f32(vdupq_n_f32(C3), l, f);
+    l = vfmaq_f32(vdupq_n_f32(C2), l, f);
+    l = vfmaq_f32(vdupq_n_f32(C1), l, f);
+    return vmulq_n_f32(vfmaq_f32(vcvtq_f32_s32(e), l, f), DB_PER_OCTAVE);
+}
+
+static void power_db_neon(const float *P, float *dB, size_t n, float norm2)
+{
+    size_t i = 0;
+    for(;i+4<=n;i+=4){
+        float32x4_t p = vmulq_n_f32(vld1q_f32(P + i), norm2);
+        vst1q_f32(dB + i, decibel_neon(p));
+    }
+    power_db_scalar(P + i, dB + i, n - i, norm2);
+}
+
+static void complex_db_neon(const float *X, float *dB, size_t n, float norm2)
+{
+    size_t i = 0;
+    for(;i+4<=n;i+=4){
+        float32x4x2_t z = vld2q_f32(X + 2*i);
+        float32x4_t p = vfmaq_f32(vmulq_f32(z.val[0], z.val[0]),
+            z.val[1], z.val[1]);
+        vst1q_f32(dB + i, decibel_neon(vmulq_n_f32(p, norm2)));
+    }
+    complex_db_scalar(X + 2*i, dB + i, n - i, norm2);
+}
+#endif
+
+static DecibelKernel kernel_forced = DECIBEL_AUTO;
+
+static DecibelKernel active_kernel(void)
+{
+    if(kernel_forced!=DECIBEL_AUTO)
+        return kernel_forced;
+#if defined(__x86_64__) || defined(__i386__)
+    return have_avx2() ? DECIBEL_AVX2 : DECIBEL_SSE2;
+#elif defined(__aarch64__)
+    return DECIBEL_NEON;
+#else
+    return DECIBEL_SCALAR;
+#endif
+}
+
+void Decibel::PowerTodB(const float *P, float *dB, size_t n, float norm2)
+{
+    switch(active_kernel()){
+#if defined(__x86_64__) || defined(__i386__)
+    case DECIBEL_AVX2:
+        power_db_avx2(P, dB, n, norm2);
+        break;
+    case DECIBEL_SSE2:
+        power_db_sse2(P, dB, n, norm2);
+        break;
+#elif defined(__aarch64__)
+    case DECIBEL_NEON:
+        power_db_neon(P, dB, n, norm2);
+        break;
+#endif
+    default:
+        power_db_scalar(P, dB, n, norm2);
+        break;
+    }
+}
+
+void Decibel::ComplexTodB(const float *X, float *dB, size_t n, float norm2)
+{
+    switch(active_kernel()){
+#if defined(__x86_64__) || defined(__i386__)
+    case DECIBEL_AVX2:
+        complex_db_avx2(X, dB, n, norm2);
+        break;
+    case DECIBEL_SSE2:
+        complex_db_sse2(X, dB, n, norm2);
+        break;
+#elif defined(__aarch64__)
+    case DECIBEL_NEON:
+        complex_db_neon(X, dB, n, norm2);
+        break;
+#endif
+    default:
+        complex_db_scalar(X, dB, n, norm2);
+        break;
+    }
+}
+
+void Decibel::PowerTodBReference(const float *P, float *dB, size_t n, float norm2)
+{
+    for(size_t i=0;i<n;i++){
+        float pow_X = P[i]*norm2;
+        if(pow_X < DECIBEL_POWER_MIN) pow_X = DECIBEL_POWER_MIN;
+        dB[i] = 10.0f*log10f(pow_X);
+    }
+}
+
+const char* Decibel::KernelName(void)
+{
+    switch(active_kernel()){
+    case DECIBEL_SSE2: return "sse2";
+    case DECIBEL_AVX2: return "avx2";
+    case DECIBEL_NEON: return "neon";
+    default:           return "scalar";
+    }
+}
+
+bool Decibel::SetKernel(DecibelKernel kernel)
+{
+    switch(kernel){
+    case DECIBEL_AUTO:
+    case DECIBEL_SCALAR:
+        break;
+#if defined(__x86_64__) || defined(__i386__)
+    case DECIBEL_SSE2:
+        break;
+    case DECIBEL_AVX2:
+        if(!have_avx2()) return false;
+        break;
+#elif defined(__aarch64__)
+    case DECIBEL_NEON:
+        break;
+#endif
+    default:
+        return false;
+    }
+    kernel_forced = kernel;
+    return true;
+}
@@ -0,0 +1,66 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+/*
+  ==============================================================================
+
+    Decibel.h
+
+    Power to dB conversion for whole spectra. dB = 10*log10(max(P*norm2,
+    DECIBEL_POWER_MIN)), with log2 taken from the exponent bits and a
+    degree 5 polynomial of the mantissa reduced to [sqrt(1/2), sqrt(2)).
+    The error is below 1e-4 dB over the whole range, far under what
+    the display resolves.
+
+    The SSE2, AVX2/FMA and NEON kernels are chosen at run time and
+    give the same results as the scalar version to within rounding.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <stddef.h>
+
+// power floor, -180 dB
+#define DECIBEL_POWER_MIN 1e-18f
+
+enum DecibelKernel
+{
+    DECIBEL_AUTO = 0, // the fastest one the CPU runs
+    DECIBEL_SCALAR,
+    DECIBEL_SSE2,
+    DECIBEL_AVX2,
+    DECIBEL_NEON
+};
+
+class Decibel
+{
+public:
+    // dB[i] from the power P[i]*norm2, in place is allowed
+    static void PowerTodB(const float *P, float *dB, size_t n, float norm2);
+    // dB[i] from the power of the interleaved complex X[2i], X[2i+1]
+    static void ComplexTodB(const float *X, float *dB, size_t n, float norm2);
+    // the log10f version the kernels are checked against
+    static void PowerTodBReference(const float *P, float *dB, size_t n, float norm2);
+    // name of the kernel in use
+    static const char* KernelName(void);
+    // force a kernel, for the tests and benchmarks; false, with the
+    // choice unchanged, if this build or CPU can't run it
+    static bool SetKernel(DecibelKernel kernel);
+};
@@ -0,0 +1,562 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  ==============================================================================
+
+    FFT.cpp
+
+  ==============================================================================
+*/
+
+#include "FFT.h"
+#include "Decibel.h"
+#include <new>
+#include <mutex>
+#include <stdexcept>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+extern char **environ;
+
+// upper bound on each plan measured by the wisdom tool, in seconds
+#define FFT_MEASURE_TIMELIMIT   5.0
+
+// The fftw planner is not thread safe. The mutex serialises planning
+// within this binary; the plugin and the UI are separate binaries
+// sharing one libfftw3, so the library's own planner lock is also
+// enabled. It is held only around each call into the planner.
+static std::mutex planner_mutex;
+static std::once_flag planner_once;
+
+// FNV-1a of the CPU model so that wisdom is not reused across machines
+static uint32_t cpu_key(void)
+{
+    uint32_t h = 2166136261u;
+    FILE *f = fopen("/proc/cpuinfo", "r");
+    if(!f) return h;
+    char line[256];
+    while(fgets(line, sizeof(line), f)){
+        if(strncmp(line, "model name", 10)==0){
+            for(char *p=line;*p;p++){
+                h ^= (uint8_t)*p;
+                h *= 16777619u;
+            }
+            break;
+        }
+    }
+    fclose(f);
+    return h;
+}
+
+// $XDG_CACHE_HOME/SignalView, or ~/.cache/SignalView, created if missing
+static bool cache_dir(char *dir, size_t len)
+{
+    const char *xdg = getenv("XDG_CACHE_HOME");
+    const char *home = getenv("HOME");
+    int n;
+    if(xdg && xdg[0]){
+        n = snprintf(dir, len, "%s", xdg);
+    }else if(home && home[0]){
+        n = snprintf(dir, len, "%s/.cache", home);
+    }else{
+        return false;
+    }
+    if(n<0 || (size_t)n>=len) return false;
+    mkdir(dir, 0755);
+    if((size_t)n + sizeof("/SignalView") > len) return false;
+    strcat(dir, "/SignalView");
+    if(mkdir(dir, 0755)!=0){
+        struct stat st;
+        if(stat(dir, &st)!=0 || !S_ISDIR(st.st_mode)) return false;
+    }
+    return true;
+}
+
+// the cache file of one FFT shape
+static bool wisdom_file(char *path, size_t len, int Nfft, int Nchannels,
+    FFTPrecision precision)
+{
+    char dir[1024];
+    if(!cache_dir(dir, sizeof(dir))) return false;
+    int n = snprintf(path, len, "%s/fftw-%c-%d-%d-%08x.wisdom", dir,
+        precision==FFT_FLOAT ? 'f' : 'd', Nfft, Nchannels, cpu_key());
+    return n>=0 && (size_t)n<len;
+}
+
+// Nchannels real frames, Nfft samples apart in and Npoints bins apart out.
+// The time limit only applies to this call.
+static fftwf_plan plan_real(int Nfft, int Nchannels, float *x, fftwf_complex *X,
+    unsigned flags, double timelimit = FFTW_NO_TIMELIMIT)
+{
+    int n = Nfft;
+    std::lock_guard<std::mutex> lock(planner_mutex);
+    fftwf_set_timelimit(timelimit);
+    return fftwf_plan_many_dft_r2c(1, &n, Nchannels, x, NULL, 1, Nfft,
+        X, NULL, 1, Nfft/2 + 1, flags);
+}
+
+static fftw_plan plan_real(int Nfft, int Nchannels, double *x, fftw_complex *X,
+    unsigned flags, double timelimit = FFTW_NO_TIMELIMIT)
+{
+    int n = Nfft;
+    std::lock_guard<std::mutex> lock(planner_mutex);
+    fftw_set_timelimit(timelimit);
+    return fftw_plan_many_dft_r2c(1, &n, Nchannels, x, NULL, 1, Nfft,
+        X, NULL, 1, Nfft/2 + 1, flags);
+}
+
+// Npairs complex frames, Nfft samples apart in and out
+static fftwf_plan plan_pairs(int Nfft, int Npairs, fftwf_complex *z,
+    fftwf_complex *Z, unsigned flags, double timelimit = FFTW_NO_TIMELIMIT)
+{
+    int n = Nfft;
+    std::lock_guard<std::mutex> lock(planner_mutex);
+    fftwf_set_timelimit(timelimit);
+    return fftwf_plan_many_dft(1, &n, Npairs, z, NULL, 1, Nfft,
+        Z, NULL, 1, Nfft, FFTW_FORWARD, flags);
+}
+
+static fftw_plan plan_pairs(int Nfft, int Npairs, fftw_complex *z,
+    fftw_complex *Z, unsigned flags, double timelimit = FFTW_NO_TIMELIMIT)
+{
+    int n = Nfft;
+    std::lock_guard<std::mutex> lock(planner_mutex);
+    fftw_set_timelimit(timelimit);
+    return fftw_plan_many_dft(1, &n, Npairs, z, NULL, 1, Nfft,
+        Z, NULL, 1, Nfft, FFTW_FORWARD, flags);
+}
+
+static void destroy_plan(fftwf_plan p)
+{
+    if(!p) return;
+    std::lock_guard<std::mutex> lock(planner_mutex);
+    fftwf_destroy_plan(p);
+}
+
+static void destroy_plan(fftw_plan p)
+{
+    if(!p) return;
+    std::lock_guard<std::mutex> lock(planner_mutex);
+    fftw_destroy_plan(p);
+}
+
+// the wisdom calls read and write the planner's global state too
+static void import_wisdom(const char *path, FFTPrecision precision)
+{
+    std::lock_guard<std::mutex> lock(planner_mutex);
+    if(precision==FFT_FLOAT)
+        fftwf_import_wisdom_from_filename(path);
+    else
+        fftw_import_wisdom_from_filename(path);
+}
+
+// written to a temporary file and renamed so that a reader never sees
+// a partial file
+static bool export_wisdom(const char *path, FFTPrecision precision)
+{
+    char tmp[1040];
+    snprintf(tmp, sizeof(tmp), "%s.%d", path, (int)getpid());
+    int ok;
+    {
+        std::lock_guard<std::mutex> lock(planner_mutex);
+        ok = precision==FFT_FLOAT ? fftwf_export_wisdom_to_filename(tmp)
+            : fftw_export_wisdom_to_filename(tmp);
+    }
+    if(ok && rename(tmp, path)==0)
+        return true;
+    unlink(tmp);
+    return false;
+}
+
+/*
+    The wisdom tool measures in a child process so that the planner of
+    this one stays free. There is one per module. A child still running
+    when the module is unloaded is stopped and waited for; the time limit
+    of each plan bounds how long it could run otherwise.
+*/
+class WisdomTool
+{
+    std::mutex mutex;
+    char path[1024];
+    pid_t pid;
+
+    // true while the last child is running, reaps it once it has exited
+    bool Running(void)
+    {
+        if(pid<=0) return false;
+        if(waitpid(pid, nullptr, WNOHANG)==0) return true;
+        pid = 0;
+        return false;
+    }
+
+public:
+    WisdomTool(void) : pid(0) { path[0] = 0; }
+
+    ~WisdomTool(void)
+    {
+        if(Running()){
+            kill(pid, SIGTERM);
+            waitpid(pid, nullptr, 0);
+        }
+    }
+
+    void SetDir(const char *dir)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        path[0] = 0;
+        if(!dir)
+            return;
+        int n = snprintf(path, sizeof(path), "%s/SignalViewWisdom", dir);
+        if(n<0 || (size_t)n>=sizeof(path))
+            path[0] = 0;
+    }
+
+    // measure the shape unless a measurement is already running
+    void Start(int Nfft, int Nchannels, FFTPrecision precision, bool pairs)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(!path[0] || Running())
+            return;
+        char size[16], channels[16];
+        snprintf(size, sizeof(size), "%d", Nfft);
+        snprintf(channels, sizeof(channels), "%d", Nchannels);
+        char *argv[] = {path, (char*)(precision==FFT_FLOAT ? "f" : "d"),
+            size, channels, (char*)(pairs ? "1" : "0"), nullptr};
+        if(posix_spawn(&pid, path, nullptr, nullptr, argv, environ)!=0)
+            pid = 0;
+    }
+};
+
+static WisdomTool wisdom_tool;
+
+FFT::FFT(int Nfft, int Nchannels, FFTPrecision precision, bool pairs)
+    :
+    Nfft(Nfft),
+    Nchannels(Nchannels),
+    precision(precision),
+    x_f(nullptr),
+    X_f(nullptr),
+    plan_f(nullptr),
+    x_d(nullptr),
+    X_d(nullptr),
+    plan_d(nullptr),
+    z_f(nullptr),
+    Z_f(nullptr),
+    pair_plan_f(nullptr),
+    z_d(nullptr),
+    Z_d(nullptr),
+    pair_plan_d(nullptr),
+    wisdom_hit(false)
+{
+    Npoints = Nfft/2 + 1;
+    Npairs = pairs ? (Nchannels + 1)/2 : 0;
+    if(!wisdom_file(wisdom_path, sizeof(wisdom_path), Nfft, Nchannels,
+        precision))
+        wisdom_path[0] = 0;
+
+    std::call_once(planner_once, [](){
+        fftwf_make_planner_thread_safe();
+        fftw_make_planner_thread_safe();
+    });
+
+    Allocate();
+    if(!Plan()){
+        Free();
+        throw std::runtime_error("FFT: fftw planning failed");
+    }
+
+    if(!wisdom_hit && wisdom_path[0])
+        wisdom_tool.Start(Nfft, Nchannels, precision, Npairs > 0);
+}
+
+FFT::~FFT(void)
+{
+    Free();
+}
+
+void FFT::Allocate(void)
+{
+    if(precision==FFT_FLOAT){
+        x_f = fftwf_alloc_real(Nfft*Nchannels);
+        X_f = fftwf_alloc_complex(Npoints*Nchannels);
+        if(Npairs){
+            z_f = fftwf_alloc_complex(Nfft*Npairs);
+            Z_f = fftwf_alloc_complex(Nfft*Npairs);
+        }
+        if(!x_f || !X_f || (Npairs && (!z_f || !Z_f))){
+            Free();
+            throw std::bad_alloc();
+        }
+    }else{
+        x_d = fftw_alloc_real(Nfft*Nchannels);
+        X_d = fftw_alloc_complex(Npoints*Nchannels);
+        if(Npairs){
+            z_d = fftw_alloc_complex(Nfft*Npairs);
+            Z_d = fftw_alloc_complex(Nfft*Npairs);
+        }
+        if(!x_d || !X_d || (Npairs && (!z_d || !Z_d))){
+            Free();
+            throw std::bad_alloc();
+        }
+    }
+}
+
+/*
+    Import the cached wisdom and ask for measured plans without running
+    the planner. On a miss fall back to estimated plans, which are ready
+    in microseconds. Returns false if no plan could be made.
+*/
+bool FFT::Plan(void)
+{
+    if(wisdom_path[0]) import_wisdom(wisdom_path, precision);
+    if(precision==FFT_FLOAT){
+        plan_f = plan_real(Nfft, Nchannels, x_f, X_f,
+            FFTW_MEASURE | FFTW_WISDOM_ONLY);
+        if(Npairs)
+            pair_plan_f = plan_pairs(Nfft, Npairs, z_f, Z_f,
+                FFTW_MEASURE | FFTW_WISDOM_ONLY);
+        wisdom_hit = plan_f && (pair_plan_f || !Npairs);
+        if(!plan_f)
+            plan_f = plan_real(Nfft, Nchannels, x_f, X_f, FFTW_ESTIMATE);
+        if(!pair_plan_f && Npairs)
+            pair_plan_f = plan_pairs(Nfft, Npairs, z_f, Z_f, FFTW_ESTIMATE);
+        return plan_f && (pair_plan_f || !Npairs);
+    }else{
+        plan_d = plan_real(Nfft, Nchannels, x_d, X_d,
+            FFTW_MEASURE | FFTW_WISDOM_ONLY);
+        if(Npairs)
+            pair_plan_d = plan_pairs(Nfft, Npairs, z_d, Z_d,
+                FFTW_MEASURE | FFTW_WISDOM_ONLY);
+        wisdom_hit = plan_d && (pair_plan_d || !Npairs);
+        if(!plan_d)
+            plan_d = plan_real(Nfft, Nchannels, x_d, X_d, FFTW_ESTIMATE);
+        if(!pair_plan_d && Npairs)
+            pair_plan_d = plan_pairs(Nfft, Npairs, z_d, Z_d, FFTW_ESTIMATE);
+        return plan_d && (pair_plan_d || !Npairs);
+    }
+}
+
+/*
+    Run by SignalViewWisdom. FFTW_MEASURE overwrites its arrays, so the
+    plans are made on buffers of their own; only the wisdom they leave
+    behind is kept.
+*/
+bool FFT::Measure(int Nfft, int Nchannels, FFTPrecision precision, bool pairs)
+{
+    char path[1024];
+    if(!wisdom_file(path, sizeof(path), Nfft, Nchannels, precision))
+        return false;
+    const int Npoints = Nfft/2 + 1;
+    const int Npairs = pairs ? (Nchannels + 1)/2 : 0;
+    bool ok = false;
+    if(precision==FFT_FLOAT){
+        float *x = fftwf_alloc_real(Nfft*Nchannels);
+        fftwf_complex *X = fftwf_alloc_complex(Npoints*Nchannels);
+        fftwf_complex *z = Npairs ? fftwf_alloc_complex(Nfft*Npairs) : nullptr;
+        fftwf_complex *Z = Npairs ? fftwf_alloc_complex(Nfft*Npairs) : nullptr;
+        if(x && X && (!Npairs || (z && Z))){
+            fftwf_plan plan = plan_real(Nfft, Nchannels, x, X, FFTW_MEASURE,
+                FFT_MEASURE_TIMELIMIT);
+            fftwf_plan pair_plan = nullptr;
+            if(Npairs && plan)
+                pair_plan = plan_pairs(Nfft, Npairs, z, Z, FFTW_MEASURE,
+                    FFT_MEASURE_TIMELIMIT);
+            ok = plan && (pair_plan || !Npairs);
+            destroy_plan(plan);
+            destroy_plan(pair_plan);
+        }
+        if(x) fftwf_free(x);
+        if(X) fftwf_free(X);
+        if(z) fftwf_free(z);
+        if(Z) fftwf_free(Z);
+    }else{
+        double *x = fftw_alloc_real(Nfft*Nchannels);
+        fftw_complex *X = fftw_alloc_complex(Npoints*Nchannels);
+        fftw_complex *z = Npairs ? fftw_alloc_complex(Nfft*Npairs) : nullptr;
+        fftw_complex *Z = Npairs ? fftw_alloc_complex(Nfft*Npairs) : nullptr;
+        if(x && X && (!Npairs || (z && Z))){
+            fftw_plan plan = plan_real(Nfft, Nchannels, x, X, FFTW_MEASURE,
+                FFT_MEASURE_TIMELIMIT);
+            fftw_plan pair_plan = nullptr;
+            if(Npairs && plan)
+                pair_plan = plan_pairs(Nfft, Npairs, z, Z, FFTW_MEASURE,
+                    FFT_MEASURE_TIMELIMIT);
+            ok = plan && (pair_plan || !Npairs);
+            destroy_plan(plan);
+            destroy_plan(pair_plan);
+        }
+        if(x) fftw_free(x);
+        if(X) fftw_free(X);
+        if(z) fftw_free(z);
+        if(Z) fftw_free(Z);
+    }
+    return ok && export_wisdom(path, precision);
+}
+
+void FFT::SetWisdomTool(const char *dir)
+{
+    wisdom_tool.SetDir(dir);
+}
+
+void FFT::Free(void)
+{
+    destroy_plan(plan_f);
+    destroy_plan(pair_plan_f);
+    destroy_plan(plan_d);
+    destroy_plan(pair_plan_d);
+    if(x_f) fftwf_free(x_f);
+    if(X_f) fftwf_free(X_f);
+    if(x_d) fftw_free(x_d);
+    if(X_d) fftw_free(X_d);
+    if(z_f) fftwf_free(z_f);
+    if(Z_f) fftwf_free(Z_f);
+    if(z_d) fftw_free(z_d);
+    if(Z_d) fftw_free(Z_d);
+    plan_f = nullptr;
+    plan_d = nullptr;
+    pair_plan_f = nullptr;
+    pair_plan_d = nullptr;
+    x_f = nullptr;
+    X_f = nullptr;
+    x_d = nullptr;
+    X_d = nullptr;
+    z_f = nullptr;
+    Z_f = nullptr;
+    z_d = nullptr;
+    Z_d = nullptr;
+}
+
+void FFT::Execute(FFTWindow *window, const float *x)
+{
+    if(precision==FFT_FLOAT){
+        for(int c=0;c<Nchannels;c++)
+            window->Apply(x + c*Nfft, x_f + c*Nfft);
+        fftwf_execute_dft_r2c(plan_f, x_f, X_f);
+    }else{
+        for(int c=0;c<Nchannels;c++)
+            window->Apply(x + c*Nfft, x_d + c*Nfft);
+        fftw_execute_dft_r2c(plan_d, x_d, X_d);
+    }
+}
+
+void FFT::PowerSpectrum(float *P)
+{
+    int n = Npoints*Nchannels;
+    if(precision==FFT_FLOAT){
+        const float * __restrict X = (const float*)X_f;
+        float * __restrict dst = P;
+        for(int i=0;i<n;i++){
+            float re = X[2*i];
+            float im = X[2*i+1];
+            dst[i] = re*re + im*im;
+        }
+    }else{
+        const double * __restrict X = (const double*)X_d;
+        float * __restrict dst = P;
+        for(int i=0;i<n;i++){
+            double re = X[2*i];
+            double im = X[2*i+1];
+            dst[i] = (float)(re*re + im*im);
+        }
+    }
+}
+
+void FFT::DecibelSpectrum(float *dB, float norm2, int first, int count)
+{
+    if(count==0) count = Nchannels - first;
+    size_t n = (size_t)Npoints*count;
+    size_t offset = (size_t)Npoints*first;
+    if(precision==FFT_FLOAT){
+        Decibel::ComplexTodB((const float*)(X_f + offset), dB, n, norm2);
+    }else{
+        // the power is formed in double, the dB conversion in place
+        const double * __restrict X = (const double*)(X_d + offset);
+        for(size_t i=0;i<n;i++){
+            double re = X[2*i];
+            double im = X[2*i+1];
+            dB[i] = (float)(re*re + im*im);
+        }
+        Decibel::PowerTodB(dB, dB, n, norm2);
+    }
+}
+
+void FFT::ExecutePairs(FFTWindow *window, const float *x)
+{
+    for(int p=0;p<Npairs;p++){
+        const float *a = x + 2*p*Nfft;
+        const float *b = (2*p + 1 < Nchannels) ? a + Nfft : nullptr;
+        if(precision==FFT_FLOAT)
+            window->ApplyPair(a, b, (float*)(z_f + p*Nfft));
+        else
+            window->ApplyPair(a, b, (double*)(z_d + p*Nfft));
+    }
+    if(precision==FFT_FLOAT)
+        fftwf_execute_dft(pair_plan_f, z_f, Z_f);
+    else
+        fftw_execute_dft(pair_plan_d, z_d, Z_d);
+}
+
+/*
+    With z = a + jb and Z = FFT(z), W[k] = conj(Z[N-k]):
+        A[k] = (Z[k] + W[k])/2
+        B[k] = (Z[k] - W[k])/2j
+    so that
+        |A[k]|^2 = ((Zr+Wr)^2 + (Zi+Wi)^2)/4
+        |B[k]|^2 = ((Zr-Wr)^2 + (Zi-Wi)^2)/4
+    P_b is null for the last pair of an odd channel count.
+*/
+template<typename T>
+static void split_pair(const T *Z, int Nfft, int Npoints, float *P_a, float *P_b)
+{
+    for(int k=0;k<Npoints;k++){
+        int nk = (k==0) ? 0 : Nfft - k;
+        T zr = Z[2*k];
+        T zi = Z[2*k+1];
+        T wr = Z[2*nk];
+        T wi = -Z[2*nk+1];
+        T ar = zr + wr;
+        T ai = zi + wi;
+        P_a[k] = (float)((ar*ar + ai*ai)*(T)0.25);
+        if(P_b){
+            T br = zr - wr;
+            T bi = zi - wi;
+            P_b[k] = (float)((br*br + bi*bi)*(T)0.25);
+        }
+    }
+}
+
+void FFT::PowerSpectrumPairs(float *P)
+{
+    for(int p=0;p<Npairs;p++){
+        float *P_a = P + 2*p*Npoints;
+        float *P_b = (2*p + 1 < Nchannels) ? P_a + Npoints : nullptr;
+        if(precision==FFT_FLOAT)
+            split_pair((const float*)(Z_f + p*Nfft), Nfft, Npoints, P_a, P_b);
+        else
+            split_pair((const double*)(Z_d + p*Nfft), Nfft, Npoints, P_a, P_b);
+    }
+}
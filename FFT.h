@@ -0,0 +1,147 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  ==============================================================================
+
+    FFT.h
+
+    Real to complex transform engine for Nchannels frames stored
+    channel-major, Nfft samples each, run as one batched plan. Pairs of
+    channels may instead be transformed together as complex FFTs of
+    size Nfft, a + jb, and separated afterwards using the conjugate
+    symmetry of real spectra. The single precision path uses fftwf with
+    fftwf_malloc'd (SIMD aligned) buffers so that the vector codelets
+    are used. The double precision path is kept for when a very deep
+    noise floor is needed.
+
+    The pair plan is optional; a batch of frames that is only ever
+    transformed as real frames skips it.
+
+    Plans are looked up in a per-user wisdom cache keyed by size,
+    channels, precision and CPU. On a miss the FFT uses FFTW_ESTIMATE
+    plans and, if a wisdom tool has been set, starts SignalViewWisdom
+    to measure better ones into the cache for the next FFT of that
+    shape. fftw serialises its planner, so measuring in this process
+    would hold up every FFT made meanwhile.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <fftw3.h>
+#include "FFTWindow.h"
+
+#define FFT_SIZE_MIN        512
+#define FFT_SIZE_MAX        65536
+#define FFT_SIZE_DEFAULT    4096
+#define FFT_OVERLAP_MIN     1
+#define FFT_OVERLAP_MAX     16
+#define FFT_OVERLAP_DEFAULT 3
+
+enum FFTPrecision
+{
+    FFT_FLOAT = 0,
+    FFT_DOUBLE
+};
+
+class FFT
+{
+    int Nfft;
+    int Npoints;
+    int Nchannels;
+    int Npairs;
+    FFTPrecision precision;
+
+    // Nchannels real frames and their spectra, channel-major
+    float         *x_f;
+    fftwf_complex *X_f;
+    fftwf_plan     plan_f;
+
+    double        *x_d;
+    fftw_complex  *X_d;
+    fftw_plan      plan_d;
+
+    // Npairs complex frames for the packed pair transform
+    fftwf_complex *z_f;
+    fftwf_complex *Z_f;
+    fftwf_plan     pair_plan_f;
+    fftw_complex  *z_d;
+    fftw_complex  *Z_d;
+    fftw_plan      pair_plan_d;
+
+    bool               wisdom_hit;
+    char               wisdom_path[1024];
+
+    void Allocate(void);
+    bool Plan(void);
+    void Free(void);
+
+public:
+    FFT(int Nfft, int Nchannels = 1, FFTPrecision precision = FFT_FLOAT,
+        bool pairs = true);
+    ~FFT(void);
+
+    int GetSize(void) { return Nfft; }
+    int GetNumPoints(void) { return Npoints; }
+    int GetNumChannels(void) { return Nchannels; }
+    FFTPrecision GetPrecision(void) { return precision; }
+    // true when the plans were loaded from the wisdom cache
+    bool GetWisdomHit(void) { return wisdom_hit; }
+
+    // Start the SignalViewWisdom program in dir on a wisdom miss; with
+    // no dir, the default, nothing is measured. One measurement runs at
+    // a time and one still running is stopped when the module unloads.
+    static void SetWisdomTool(const char *dir);
+    // measure the plans of an FFT of this shape into the wisdom cache,
+    // run by SignalViewWisdom; false if they could not be made or saved
+    static bool Measure(int Nfft, int Nchannels, FFTPrecision precision,
+        bool pairs);
+
+    // power of two size in [FFT_SIZE_MIN, FFT_SIZE_MAX]
+    static int ValidateSize(int Nfft)
+    {
+        int N = FFT_SIZE_MIN;
+        while(N < Nfft && N < FFT_SIZE_MAX)
+            N <<= 1;
+        return N;
+    }
+
+    static int ValidateOverlap(int Ncopy)
+    {
+        if(Ncopy < FFT_OVERLAP_MIN) return FFT_OVERLAP_MIN;
+        if(Ncopy > FFT_OVERLAP_MAX) return FFT_OVERLAP_MAX;
+        return Ncopy;
+    }
+
+    // window the Nchannels frames of x, channel-major, and transform them
+    void Execute(FFTWindow *window, const float *x);
+    // |X|^2 of the last transform, Npoints values per channel
+    void PowerSpectrum(float *P);
+    // 10*log10(|X|^2*norm2) of count channel spectra from channel first,
+    // all of them when count is 0, in one pass over the transform
+    void DecibelSpectrum(float *dB, float norm2, int first = 0, int count = 0);
+
+    // as Execute, transforming channels 2k and 2k+1 as one complex
+    // frame, needs an FFT made with pairs
+    void ExecutePairs(FFTWindow *window, const float *x);
+    // split the last pair transform into |X|^2, Npoints per channel
+    void PowerSpectrumPairs(float *P);
+};
@@ -0,0 +1,185 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  ==============================================================================
+
+    FFTWindow.cpp
+
+  ==============================================================================
+*/
+
+#include "FFTWindow.h"
+#include <cmath>
+
+#define KAISER_BETA 8.6
+
+static double cosine_sum(double alpha, const double *a, int Na)
+{
+    double w = 0.0;
+    double sign = 1.0;
+    for(int k=0;k<Na;k++){
+        w += sign*a[k]*cos(2.0*M_PI*k*alpha);
+        sign = -sign;
+    }
+    return w;
+}
+
+// zeroth order modified Bessel function of the first kind
+static double bessel_i0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    double x2 = x*x/4.0;
+    for(int k=1;k<64;k++){
+        term *= x2/((double)k*k);
+        sum += term;
+        if(term < sum*1e-17)
+            break;
+    }
+    return sum;
+}
+
+static double window_func(WindowType type, double alpha)
+{
+    static const double hann[] = {0.5, 0.5};
+    static const double hamming[] = {0.53836, 0.46164};
+    static const double blackman_harris[] =
+        {0.35875, 0.48829, 0.14128, 0.01168};
+    static const double flat_top[] =
+        {0.21557895, 0.41663158, 0.277263158, 0.083578947, 0.006947368};
+
+    switch(type){
+    case WINDOW_HANN:
+        return cosine_sum(alpha, hann, 2);
+    case WINDOW_HAMMING:
+        return cosine_sum(alpha, hamming, 2);
+    case WINDOW_FLAT_TOP:
+        return cosine_sum(alpha, flat_top, 5);
+    case WINDOW_KAISER:
+    {
+        double r = 2.0*alpha - 1.0;
+        return bessel_i0(KAISER_BETA*sqrt(1.0 - r*r))/bessel_i0(KAISER_BETA);
+    }
+    case WINDOW_BLACKMAN_HARRIS:
+    default:
+        return cosine_sum(alpha, blackman_harris, 4);
+    }
+}
+
+FFTWindow::FFTWindow(WindowType type, int Nfft)
+    :
+    type(type),
+    Nfft(Nfft)
+{
+    table.reset(new float[Nfft]);
+    table_d.reset(new double[Nfft]);
+    double sum = 0.0;
+    for(int i=0;i<Nfft;i++){
+        // periodic window, alpha in [0,1)
+        double alpha = (double)i/Nfft;
+        double w = window_func(type, alpha);
+        table[i] = (float)w;
+        table_d[i] = w;
+        sum += w;
+    }
+    coherent_gain = (float)(sum/Nfft);
+}
+
+FFTWindow::~FFTWindow(void)
+{
+
+}
+
+void FFTWindow::Apply(const float *x, float *y)
+{
+    const float * __restrict w = table.get();
+    const float * __restrict src = x;
+    float * __restrict dst = y;
+    for(int i=0;i<Nfft;i++){
+        dst[i] = src[i]*w[i];
+    }
+}
+
+void FFTWindow::Apply(const float *x, double *y)
+{
+    const double * __restrict w = table_d.get();
+    const float * __restrict src = x;
+    double * __restrict dst = y;
+    for(int i=0;i<Nfft;i++){
+        dst[i] = src[i]*w[i];
+    }
+}
+
+void FFTWindow::ApplyPair(const float *a, const float *b, float *z)
+{
+    const float * __restrict w = table.get();
+    const float * __restrict src_a = a;
+    const float * __restrict src_b = b;
+    float * __restrict dst = z;
+    if(!src_b){
+        for(int i=0;i<Nfft;i++){
+            dst[2*i] = src_a[i]*w[i];
+            dst[2*i+1] = 0.0f;
+        }
+        return;
+    }
+    for(int i=0;i<Nfft;i++){
+        dst[2*i] = src_a[i]*w[i];
+        dst[2*i+1] = src_b[i]*w[i];
+    }
+}
+
+void FFTWindow::ApplyPair(const float *a, const float *b, double *z)
+{
+    const double * __restrict w = table_d.get();
+    const float * __restrict src_a = a;
+    const float * __restrict src_b = b;
+    double * __restrict dst = z;
+    if(!src_b){
+        for(int i=0;i<Nfft;i++){
+            dst[2*i] = src_a[i]*w[i];
+            dst[2*i+1] = 0.0;
+        }
+        return;
+    }
+    for(int i=0;i<Nfft;i++){
+        dst[2*i] = src_a[i]*w[i];
+        dst[2*i+1] = src_b[i]*w[i];
+    }
+}
+
+WindowType FFTWindow::Validate(int type)
+{
+    if(type<0 || type>=WINDOW_NTYPES)
+        return WINDOW_DEFAULT;
+    return (WindowType)type;
+}
+
+const char* FFTWindow::Name(WindowType type)
+{
+    switch(type){
+    case WINDOW_HANN:            return "Hann";
+    case WINDOW_HAMMING:         return "Hamming";
+    case WINDOW_BLACKMAN_HARRIS: return "Blackman-Harris";
+    case WINDOW_FLAT_TOP:        return "Flat top";
+    case WINDOW_KAISER:          return "Kaiser";
+    default:                     return "Unknown";
+    }
+}
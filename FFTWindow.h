@@ -0,0 +1,74 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  ==============================================================================
+
+    FFTWindow.h
+
+    Precomputed analysis window tables. A table is built once for a
+    (type, Nfft) pair along with its coherent gain so that windowing a
+    frame is a single multiply per sample.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <memory>
+
+enum WindowType
+{
+    WINDOW_HANN = 0,
+    WINDOW_HAMMING,
+    WINDOW_BLACKMAN_HARRIS,
+    WINDOW_FLAT_TOP,
+    WINDOW_KAISER,
+    WINDOW_NTYPES
+};
+
+#define WINDOW_DEFAULT WINDOW_BLACKMAN_HARRIS
+
+class FFTWindow
+{
+    WindowType type;
+    int Nfft;
+    float coherent_gain;
+    std::unique_ptr<float[]> table;
+    std::unique_ptr<double[]> table_d;
+
+public:
+    FFTWindow(WindowType type, int Nfft);
+    ~FFTWindow(void);
+
+    WindowType GetType(void) { return type; }
+    int GetSize(void) { return Nfft; }
+    float GetCoherentGain(void) { return coherent_gain; }
+    const float* GetTable(void) { return table.get(); }
+
+    void Apply(const float *x, float *y);
+    void Apply(const float *x, double *y);
+    // window two frames into one interleaved complex frame, a + jb
+    // b may be null for an odd channel, the imaginary part is then zero
+    void ApplyPair(const float *a, const float *b, float *z);
+    void ApplyPair(const float *a, const float *b, double *z);
+
+    static WindowType Validate(int type);
+    static const char* Name(WindowType type);
+};
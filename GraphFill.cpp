@@ -21,22 +21,25 @@
 #include "Shader.h"
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/matrix_transform.hpp>
-#include <string.h>
 #include <stdio.h>
 
 void GraphFill::ProgramLoad(void)
 {
+    // Two vertices per point of the curve, even on the curve and odd
+    // thickness below it, read from the buffers the line was drawn from.
     const char *vertShaderSrc =
         "#version 460\n"
-        "layout(location=0) in float a_x;\n"
-        "layout(location=1) in float a_y;\n"
-        "layout(location=2) in float a_value;\n"
+        "layout(std430, binding=0) readonly buffer XBuffer { float x[]; };\n"
+        "layout(std430, binding=1) readonly buffer YBuffer { float y[]; };\n"
         "out float value;\n"
         "uniform mat4 projection;\n"
+        "uniform float thickness;\n"
         "void main()\n"
         "{\n"
-        "   gl_Position = projection*vec4(a_x,a_y,0.0,1.0);\n"
-        "   value = a_value;\n"
+        "   int i = gl_VertexID >> 1;\n"
+        "   float bottom = float(gl_VertexID & 1);\n"
+        "   gl_Position = projection*vec4(x[i], y[i] - bottom*thickness, 0.0, 1.0);\n"
+        "   value = 1.0 - bottom;\n"
         "}\n";
 
     const char *fragShaderSrc =
@@ -58,6 +61,7 @@ void GraphFill::ProgramLoad(void)
 
     colorLocation = glGetUniformLocation(programObject, "color");
     projectionLocation = glGetUniformLocation(programObject, "projection");
+    thicknessLocation = glGetUniformLocation(programObject, "thickness");
 }
 
 void GraphFill::ProgramDestroy(void)
@@ -65,80 +69,14 @@ void GraphFill::ProgramDestroy(void)
     glDeleteProgram(programObject);
 }
 
-GraphFill::GraphFill(int Nvertices)
-    :Nvertices(Nvertices),
-    ytop(1.0f),
+GraphFill::GraphFill(void)
+    :ytop(1.0f),
     ybottom(-1.0f)
 {
     ProgramLoad();
 
-    glGenBuffers(1, &xVBO);
-    glGenBuffers(1, &yVBO);
-    glGenBuffers(1, &vVBO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, xVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float)*Nvertices*2,
-                 NULL, GL_DYNAMIC_DRAW);
-
-    float *xVBOmap = (float*)glMapBufferRange(GL_ARRAY_BUFFER,
-                                              0, sizeof(float)*Nvertices*2,
-                                              GL_MAP_WRITE_BIT|
-                                              GL_MAP_INVALIDATE_BUFFER_BIT);
-    for(int i=0;i<Nvertices;i++){
-        float x = ((float)i/(Nvertices-1));
-        xVBOmap[2*i] = x;
-        xVBOmap[2*i+1] = x;
-    }
-
-    glUnmapBuffer(GL_ARRAY_BUFFER);
-
-    glBindBuffer(GL_ARRAY_BUFFER, yVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float)*Nvertices*2,
-                 NULL, GL_DYNAMIC_DRAW);
-
-    float *yVBOmap = (float*)glMapBufferRange(GL_ARRAY_BUFFER,
-                                              0, sizeof(float)*Nvertices*2,
-                                              GL_MAP_WRITE_BIT|
-                                              GL_MAP_INVALIDATE_BUFFER_BIT);
-    for(int i=0;i<Nvertices;i++){
-        yVBOmap[2*i] = 0.0f;
-        yVBOmap[2*i+1] = -180.0f;
-    }
-
-    glUnmapBuffer(GL_ARRAY_BUFFER);
-
-    glBindBuffer(GL_ARRAY_BUFFER, vVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float)*Nvertices*2,
-                 NULL, GL_DYNAMIC_DRAW);
-
-    float *vVBOmap = (float*)glMapBufferRange(GL_ARRAY_BUFFER,
-                                              0, sizeof(float)*Nvertices*2,
-                                              GL_MAP_WRITE_BIT|
-                                              GL_MAP_INVALIDATE_BUFFER_BIT);
-    for(int i=0;i<Nvertices;i++){
-        vVBOmap[2*i] = 1.0f;
-        vVBOmap[2*i+1] = 0.0f;
-    }
-
-    glUnmapBuffer(GL_ARRAY_BUFFER);
-
+    // no attributes, but the core profile draws with a VAO bound
     glGenVertexArrays(1, &VAO);
-
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, xVBO);
-    glVertexAttribPointer(X_LOC, 1, GL_FLOAT, GL_FALSE, 0, NULL);
-    glEnableVertexAttribArray(X_LOC);
-
-    glBindBuffer(GL_ARRAY_BUFFER, yVBO);
-    glVertexAttribPointer(Y_LOC, 1, GL_FLOAT, GL_FALSE, 0, NULL);
-    glEnableVertexAttribArray(Y_LOC);
-
-    glBindBuffer(GL_ARRAY_BUFFER, vVBO);
-    glVertexAttribPointer(V_LOC, 1, GL_FLOAT, GL_FALSE, 0, NULL);
-    glEnableVertexAttribArray(V_LOC);
-
-    glBindVertexArray(0);
     
     view_width = 1.0f;
 
@@ -148,9 +86,6 @@ GraphFill::~GraphFill(void)
 {
     ProgramDestroy();
 
-    glDeleteBuffers(1, &xVBO);
-    glDeleteBuffers(1, &yVBO);
-    glDeleteBuffers(1, &vVBO);
     glDeleteVertexArrays(1, &VAO);
 }
 
@@ -169,43 +104,21 @@ void GraphFill::SetViewWidth(float width)
     view_width = width;
 }
 
-void GraphFill::SetX(float *x, int N)
-{
-    glBindBuffer(GL_ARRAY_BUFFER, xVBO);
-
-    float *xVBOmap = (float*)glMapBufferRange(GL_ARRAY_BUFFER,
-                                              0, sizeof(float)*N,
-                                              GL_MAP_WRITE_BIT|
-                                              GL_MAP_INVALIDATE_BUFFER_BIT);
-    for(int i=0;i<N;i++){
-        xVBOmap[2*i] = x[i];
-        xVBOmap[2*i+1] = x[i];
-    }
-
-    glUnmapBuffer(GL_ARRAY_BUFFER);
-}
-
 
-void GraphFill::Draw(float *y0, int N)
+void GraphFill::Draw(GLuint x_buffer, GLuint y_buffer, GLintptr y_offset, int N)
 {
     //glEnable(GL_BLEND);
     //glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    float thickness = (ytop - ybottom)*0.5f;
-
-    glBindBuffer(GL_ARRAY_BUFFER, yVBO);
-
-    float *yVBOmap = (float *)glMapBufferRange(
-        GL_ARRAY_BUFFER,
-        0, sizeof(float) * N*2,
-        GL_MAP_WRITE_BIT);
+    if(N < 2 || y_offset < 0)
+        return;
 
-    for(int i=0;i<N;i++){
-        yVBOmap[i*2] = y0[i];
-        yVBOmap[i*2+1] = y0[i]-thickness;
-    }
+    float thickness = (ytop - ybottom)*0.5f;
 
-    glUnmapBuffer(GL_ARRAY_BUFFER);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, GRAPH_FILL_X_BINDING,
+                      x_buffer, 0, sizeof(float)*N);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, GRAPH_FILL_Y_BINDING,
+                      y_buffer, y_offset, sizeof(float)*N);
 
     glUseProgram(programObject);
 
@@ -220,6 +133,7 @@ void GraphFill::Draw(float *y0, int N)
     glm::mat4 projection = glm::ortho(left, right, bottom, top, near, far);
 
     glUniformMatrix4fv(projectionLocation, 1, GL_FALSE, glm::value_ptr(projection));
+    glUniform1f(thicknessLocation, thickness);
 
     glUniform4fv(colorLocation, 1, glm::value_ptr(color));
     glDrawArrays(GL_TRIANGLE_STRIP, 0, N*2);
@@ -33,20 +33,18 @@
 #include <glad/gl.h>
 #include <glm/glm.hpp>
 
-#define X_LOC 0
-#define Y_LOC 1
-#define V_LOC 2
+// the line's x and y, bound as shader storage
+#define GRAPH_FILL_X_BINDING 0
+#define GRAPH_FILL_Y_BINDING 1
 
 class GraphFill
 {
     GLuint programObject;
     GLint  colorLocation;
     GLint  projectionLocation;
-    GLuint xVBO;
-    GLuint yVBO;
-    GLuint vVBO;
+    GLint  thicknessLocation;
+    // no attributes, the vertices come from the line's buffers
     GLuint VAO;
-    int Nvertices;
     glm::vec4 color;
     float ytop;
     float ybottom;
@@ -56,12 +54,13 @@ class GraphFill
     void ProgramDestroy(void);
 
 public:
-    GraphFill(int Nvertices);
+    GraphFill(void);
     ~GraphFill(void);
     void SetColor(glm::vec4 &color);
     void SetLimits(float ytop, float ybottom);
     void SetViewWidth(float width);
-    void SetX(float *x, int N);
-    void Draw(float *y, int N);
+    // fill below the N points an LGraph drew, x from the start of
+    // x_buffer and y at y_offset of y_buffer
+    void Draw(GLuint x_buffer, GLuint y_buffer, GLintptr y_offset, int N);
 };
 
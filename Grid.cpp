@@ -282,7 +282,8 @@ Grid::Grid(int Nfft, float sample_rate, const char* bundle_path):
     dB_top(0.0f),
     dB_bottom(-180.0f),
     view_width(1.0f),
-    font_height(12)
+    font_height(12),
+    dropped(0)
 {
     ProgramLoad();
 
@@ -354,6 +355,22 @@ void Grid::SetViewWidth(float view_width)
     Grid::view_width = view_width;
 }
 
+void Grid::SetDropped(uint64_t dropped)
+{
+    Grid::dropped = dropped;
+}
+
+void Grid::DrawDropped(void)
+{
+    if(dropped==0)
+        return;
+    unsigned long long n = dropped;
+    float advance = dB_font.PrintfAdvance("dropped %llu", n);
+    double xs = floor(viewport[2] - advance - 4.0);
+    double ys = viewport[3] - 2*font_height - 4.0;
+    dB_font.Printf(xs, ys, "dropped %llu", n);
+}
+
 void Grid::DrawLogFrequencyText(float frequency, const char *text)
 {
     float x = x_LogDisplacement(frequency);
@@ -512,4 +529,6 @@ void Grid::Draw(void)
     }else{
         DrawLinearFrequency();
     }
+
+    DrawDropped();
 }
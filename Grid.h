@@ -58,6 +58,7 @@
 
 #include <glad/gl.h>
 #include <glm/glm.hpp>
+#include <cstdint>
 #include "Font.h"
 
 #define N_LOG_DECADE 4
@@ -109,6 +110,7 @@ class Grid
     FreeTypeFont dB_font;
     int font_height;
     char font_path[1024];
+    uint64_t dropped;
 
     void ProgramLoad(void);
     void ProgramDestroy(void);
@@ -126,6 +128,7 @@ class Grid
     float y_dBDisplacement(float dB);
 
     void DrawBorder(void);
+    void DrawDropped(void);
     void Draw_dBText(float dB);
     void Draw_dB();
     void DrawLogFrequency(void);
@@ -137,5 +140,6 @@ public:
     void SetFrequency(bool log=false);
     void SetLimits(float dB_top, float dB_bottom);
     void SetViewWidth(float view_width);
+    void SetDropped(uint64_t dropped);
     void Draw(void);
 };
@@ -28,60 +28,20 @@
 */
 
 #include "LGraph.h"
-#include "Shader.h"
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <string.h>
 #include <stdio.h>
 
-void LGraph::ProgramLoad(void)
-{
-    const char *vertShaderSrc =
-        "#version 460\n"
-        "layout(location=0) in float a_x;\n"
-        "layout(location=1) in float a_y;\n"
-        "uniform mat4 projection;\n"
-        "void main()\n"
-        "{\n"
-        "   gl_Position = projection*vec4(a_x,a_y,0.0,1.0);\n"
-        "}\n";
-
-    const char *fragShaderSrc =
-        "#version 460\n"
-        "layout(location = 0) out vec4 f_color;\n"
-        "uniform vec4 color;\n"
-        "void main()\n"
-        "{\n"
-        "   f_color = color;\n"
-        "}\n";
-
-    programObject = LoadProgram(vertShaderSrc, fragShaderSrc);
-    if (!programObject)
-    {
-        printf("lgraph.cpp: Error, couldn't load program.\n");
-        return;
-    }
-
-    colorLocation = glGetUniformLocation(programObject, "color");
-    projectionLocation = glGetUniformLocation(programObject, "projection");
-}
-
-void LGraph::ProgramDestroy(void)
-{
-    glDeleteProgram(programObject);
-}
-
-LGraph::LGraph(int Nvertices)
-    :Nvertices(Nvertices),
+LGraph::LGraph(int Nvertices, StreamBuffer *stream)
+    :stream(stream),
+    Nvertices(Nvertices),
     lineWidth0(1.0),
     lineWidth1(3.0),
     ytop(1.0),
     ybottom(-1.0)
 {
-    ProgramLoad();
-
     glGenBuffers(1, &xVBO);
-    glGenBuffers(1, &yVBO);
 
     glBindBuffer(GL_ARRAY_BUFFER, xVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(float)*Nvertices,
@@ -96,24 +56,6 @@ LGraph::LGraph(int Nvertices)
     }
 
     glUnmapBuffer(GL_ARRAY_BUFFER);
-
-    glBindBuffer(GL_ARRAY_BUFFER, yVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float)*Nvertices,
-                 NULL, GL_STREAM_DRAW);
-
-    glGenVertexArrays(1, &VAO);
-
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, xVBO);
-    glVertexAttribPointer(X_LOC, 1, GL_FLOAT, GL_FALSE, 0, NULL);
-    glEnableVertexAttribArray(X_LOC);
-
-    glBindBuffer(GL_ARRAY_BUFFER, yVBO);
-    glVertexAttribPointer(Y_LOC, 1, GL_FLOAT, GL_FALSE, 0, NULL);
-    glEnableVertexAttribArray(Y_LOC);
-
-    glBindVertexArray(0);
     
     view_width = 1.0f;
 
@@ -121,11 +63,7 @@ LGraph::LGraph(int Nvertices)
 
 LGraph::~LGraph(void)
 {
-    ProgramDestroy();
-
     glDeleteBuffers(1, &xVBO);
-    glDeleteBuffers(1, &yVBO);
-    glDeleteVertexArrays(1, &VAO);
 }
 
 void LGraph::SetColors(glm::vec4 &color0, glm::vec4 &color1){
@@ -152,38 +90,22 @@ void LGraph::SetViewWidth(float width)
 
 void LGraph::SetX(float *x, int N)
 {
+    // only when the plot layout changes
     glBindBuffer(GL_ARRAY_BUFFER, xVBO);
-
-    float *xVBOmap = (float*)glMapBufferRange(GL_ARRAY_BUFFER,
-                                              0, sizeof(float)*N,
-                                              GL_MAP_WRITE_BIT|
-                                              GL_MAP_INVALIDATE_BUFFER_BIT);
-    for(int i=0;i<N;i++){
-        xVBOmap[i] = x[i];
-    }
-
-    glUnmapBuffer(GL_ARRAY_BUFFER);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(float)*N, x);
 }
 
 
-void LGraph::Draw(float *y0, int N)
+GLintptr LGraph::Draw(float *y0, int N)
 {
     //glEnable(GL_BLEND);
     //glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    glBindBuffer(GL_ARRAY_BUFFER, yVBO);
-
-    float *yVBOmap = (float*)glMapBufferRange(GL_ARRAY_BUFFER,
-                                              0, sizeof(float)*N,
-                                              GL_MAP_WRITE_BIT|
-                                              GL_MAP_INVALIDATE_BUFFER_BIT);
-    memcpy(yVBOmap, y0, sizeof(float)*N);
-
-    glUnmapBuffer(GL_ARRAY_BUFFER);
-
-    glUseProgram(programObject);
-
-    glBindVertexArray(VAO);
+    GLintptr offset;
+    float *y = (float*)stream->Allocate(sizeof(float)*N, offset);
+    if(!y)
+        return -1;
+    memcpy(y, y0, sizeof(float)*N);
 
     float top = ytop;
     float bottom = ybottom;
@@ -193,18 +115,12 @@ void LGraph::Draw(float *y0, int N)
     float far = -1.0f;
     glm::mat4 projection = glm::ortho(left, right, bottom, top, near, far);
 
-    glUniformMatrix4fv(projectionLocation, 1, GL_FALSE, glm::value_ptr(projection));
-
-    glUniform4fv(colorLocation, 1, glm::value_ptr(color0));
-    glLineWidth(lineWidth0);
-    glDrawArrays(GL_LINE_STRIP, 0, N);
-
-    glUniform4fv(colorLocation, 1, glm::value_ptr(color1));
-    glLineWidth(lineWidth1);
-    glDrawArrays(GL_LINE_STRIP, 0, N);
-
-    glBindVertexArray(0);
-    glUseProgram(0);
+    // the glow and the core in one draw
+    const glm::vec4 colors[2] = {color0, color1};
+    const float widths[2] = {lineWidth0, lineWidth1};
+    line.Draw(projection, xVBO, 0, stream->GetBuffer(), offset, 0, 0,
+              N, colors, widths);
+    return offset;
 }
 
 
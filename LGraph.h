@@ -32,18 +32,15 @@
 
 #include <glad/gl.h>
 #include <glm/glm.hpp>
-
-#define X_LOC 0
-#define Y_LOC 1
+#include "StreamBuffer.h"
+#include "ThickLine.h"
 
 class LGraph
 {
-    GLuint programObject;
-    GLint  colorLocation;
-    GLint  projectionLocation;
     GLuint xVBO;
-    GLuint yVBO;
-    GLuint VAO;
+    // y is written to the stream buffer by each Draw
+    StreamBuffer *stream;
+    ThickLine line;
     int Nvertices;
     glm::vec4 color0;
     glm::vec4 color1;
@@ -53,17 +50,17 @@ class LGraph
     float ybottom;
     float view_width;
 
-    void ProgramLoad(void);
-    void ProgramDestroy(void);
-
 public:
-    LGraph(int Nvertices);
+    LGraph(int Nvertices, StreamBuffer *stream);
     ~LGraph(void);
     void SetColors(glm::vec4 &color0, glm::vec4 &color1);
     void SetLineWidths(float lineWidth0, float lineWidth1);
     void SetLimits(float ytop, float ybottom);
     void SetViewWidth(float width);
     void SetX(float *x, int N);
-    void Draw(float *y, int N);
+    GLuint GetXBuffer(void) { return xVBO; }
+    // the offset of y in the stream buffer, for the fill to share, or
+    // -1 if it couldn't be written
+    GLintptr Draw(float *y, int N);
 };
 
@@ -0,0 +1,162 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  ==============================================================================
+
+    MinMaxPyramid.cpp
+
+  ==============================================================================
+*/
+
+#include "MinMaxPyramid.h"
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+MinMaxPyramid::MinMaxPyramid(int N)
+    :N(N),
+    x(nullptr)
+{
+    // keep at least four blocks in the top level
+    Nlevels = 0;
+    for(int B=4;B<=N/4 && Nlevels<PYRAMID_LEVELS_MAX;B*=4){
+        lo[Nlevels].reset(new float[N/B]);
+        hi[Nlevels].reset(new float[N/B]);
+        Nlevels++;
+    }
+}
+
+MinMaxPyramid::~MinMaxPyramid(void)
+{
+}
+
+/*
+    The min of each block of 4 values of src_lo and the max of each of
+    src_hi, n blocks. Four blocks are transposed so that their values
+    are reduced side by side.
+*/
+static void reduce4(const float *src_lo, const float *src_hi,
+                    float *dst_lo, float *dst_hi, int n)
+{
+    int j = 0;
+#if defined(__SSE__)
+    for(;j+4<=n;j+=4){
+        __m128 a = _mm_loadu_ps(src_lo + 4*j);
+        __m128 b = _mm_loadu_ps(src_lo + 4*j + 4);
+        __m128 c = _mm_loadu_ps(src_lo + 4*j + 8);
+        __m128 d = _mm_loadu_ps(src_lo + 4*j + 12);
+        _MM_TRANSPOSE4_PS(a, b, c, d);
+        _mm_storeu_ps(dst_lo + j, _mm_min_ps(_mm_min_ps(a, b), _mm_min_ps(c, d)));
+        a = _mm_loadu_ps(src_hi + 4*j);
+        b = _mm_loadu_ps(src_hi + 4*j + 4);
+        c = _mm_loadu_ps(src_hi + 4*j + 8);
+        d = _mm_loadu_ps(src_hi + 4*j + 12);
+        _MM_TRANSPOSE4_PS(a, b, c, d);
+        _mm_storeu_ps(dst_hi + j, _mm_max_ps(_mm_max_ps(a, b), _mm_max_ps(c, d)));
+    }
+#elif defined(__ARM_NEON)
+    for(;j+4<=n;j+=4){
+        float32x4x4_t v = vld4q_f32(src_lo + 4*j);
+        vst1q_f32(dst_lo + j, vminq_f32(vminq_f32(v.val[0], v.val[1]),
+                                        vminq_f32(v.val[2], v.val[3])));
+        v = vld4q_f32(src_hi + 4*j);
+        vst1q_f32(dst_hi + j, vmaxq_f32(vmaxq_f32(v.val[0], v.val[1]),
+                                        vmaxq_f32(v.val[2], v.val[3])));
+    }
+#endif
+    for(;j<n;j++){
+        float l = src_lo[4*j];
+        float h = src_hi[4*j];
+        for(int i=1;i<4;i++){
+            float vl = src_lo[4*j+i];
+            float vh = src_hi[4*j+i];
+            l = vl < l ? vl : l;
+            h = vh > h ? vh : h;
+        }
+        dst_lo[j] = l;
+        dst_hi[j] = h;
+    }
+}
+
+void MinMaxPyramid::Build(const float *x)
+{
+    MinMaxPyramid::x = x;
+    const float *src_lo = x;
+    const float *src_hi = x;
+    int n = N;
+    for(int k=0;k<Nlevels;k++){
+        n /= 4;
+        reduce4(src_lo, src_hi, lo[k].get(), hi[k].get(), n);
+        src_lo = lo[k].get();
+        src_hi = hi[k].get();
+    }
+}
+
+/*
+    Min and max of the samples a to b-1. From a the walk takes the
+    largest block that starts there and ends by b, so it climbs the
+    levels while it reaches alignment and comes back down near b.
+*/
+void MinMaxPyramid::Range(int a, int b, float &y_min, float &y_max)
+{
+    float l = x[a];
+    float h = x[a];
+    int i = a;
+    while(i < b){
+        int k = -1;
+        int B = 1;
+        while(k+1 < Nlevels){
+            int B_next = B*4;
+            if((i & (B_next-1)) || i + B_next > b)
+                break;
+            B = B_next;
+            k++;
+        }
+        float vl, vh;
+        if(k < 0){
+            vl = vh = x[i];
+        }else{
+            vl = lo[k][i/B];
+            vh = hi[k][i/B];
+        }
+        l = vl < l ? vl : l;
+        h = vh > h ? vh : h;
+        i += B;
+    }
+    y_min = l;
+    y_max = h;
+}
+
+void MinMaxPyramid::Envelope(double start, double length, int n_cols,
+                             float *y_min, float *y_max)
+{
+    double step = length/n_cols;
+    int a = (int)start;
+    for(int p=0;p<n_cols;p++){
+        int b = (int)(start + (p+1)*step);
+        if(a < 0) a = 0;
+        if(b > N-1) b = N-1;
+        if(a > b) a = b;
+        Range(a, b+1, y_min[p], y_max[p]);
+        a = b;
+    }
+}
@@ -0,0 +1,65 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  ==============================================================================
+
+    MinMaxPyramid.h
+
+    Min/max envelope of a frame of N samples for drawing it narrower
+    than one pixel per sample. Level k holds the min and max of the
+    blocks of 4^(k+1) samples, so the envelope of any span is found from
+    a few blocks of each level and a few samples at its ends, whatever
+    part of the frame is in view.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <memory>
+
+#define PYRAMID_LEVELS_MAX 8
+
+class MinMaxPyramid
+{
+    int N;
+    int Nlevels;
+    const float *x;
+    std::unique_ptr<float[]> lo[PYRAMID_LEVELS_MAX];
+    std::unique_ptr<float[]> hi[PYRAMID_LEVELS_MAX];
+
+    void Range(int a, int b, float &y_min, float &y_max);
+
+public:
+    MinMaxPyramid(int N);
+    ~MinMaxPyramid(void);
+
+    int GetSize(void) { return N; }
+    int GetNumLevels(void) { return Nlevels; }
+
+    // build the levels from the N samples of x, which must stay valid
+    // until the envelope is taken
+    void Build(const float *x);
+    // min and max of n_cols equal columns over the samples from start
+    // to start+length, each column taking in the first sample of the
+    // next so that neighbouring columns join
+    void Envelope(double start, double length, int n_cols,
+                  float *y_min, float *y_max);
+};
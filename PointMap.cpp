@@ -0,0 +1,99 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+/*
+  ==============================================================================
+
+    PointMap.cpp
+
+  ==============================================================================
+*/
+
+#include "PointMap.h"
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/*
+    The peak of the n values of x.
+*/
+static float span_max(const float *x, int n)
+{
+    int i = 0;
+    float m = x[0];
+#if defined(__SSE__)
+    if(n >= 8){
+        __m128 m0 = _mm_loadu_ps(x);
+        __m128 m1 = _mm_loadu_ps(x + 4);
+        for(i=8;i+8<=n;i+=8){
+            m0 = _mm_max_ps(m0, _mm_loadu_ps(x + i));
+            m1 = _mm_max_ps(m1, _mm_loadu_ps(x + i + 4));
+        }
+        m0 = _mm_max_ps(m0, m1);
+        m0 = _mm_max_ps(m0, _mm_movehl_ps(m0, m0));
+        m0 = _mm_max_ss(m0, _mm_shuffle_ps(m0, m0, 1));
+        m = _mm_cvtss_f32(m0);
+    }
+#elif defined(__ARM_NEON)
+    if(n >= 8){
+        float32x4_t m0 = vld1q_f32(x);
+        float32x4_t m1 = vld1q_f32(x + 4);
+        for(i=8;i+8<=n;i+=8){
+            m0 = vmaxq_f32(m0, vld1q_f32(x + i));
+            m1 = vmaxq_f32(m1, vld1q_f32(x + i + 4));
+        }
+        m0 = vmaxq_f32(m0, m1);
+        float32x2_t h = vpmax_f32(vget_low_f32(m0), vget_high_f32(m0));
+        h = vpmax_f32(h, h);
+        m = vget_lane_f32(h, 0);
+    }
+#endif
+    for(;i<n;i++){
+        if(x[i]>m)
+            m = x[i];
+    }
+    return m;
+}
+
+/*
+    Catmull-Rom interpolation between X[i] and X[i+1] of the N values of
+    X, t from 0 to 1.
+*/
+static inline float interpolate_bins(const float *X, int N, int i, float t)
+{
+    float xm = X[i > 0 ? i-1 : 0];
+    float x0 = X[i];
+    float x1 = X[i+1 < N ? i+1 : N-1];
+    float x2 = X[i+2 < N ? i+2 : N-1];
+    return x0 + 0.5f*t*((x1 - xm)
+        + t*((2.0f*xm - 5.0f*x0 + 4.0f*x1 - x2)
+        + t*(3.0f*(x0 - x1) + x2 - xm)));
+}
+
+void PoolPoints(const PointSpan *map, int n, const float *X, int N, float *X_p)
+{
+    for(int p=0;p<n;p++){
+        const PointSpan span = map[p];
+        if(span.i1 > span.i0)
+            X_p[p] = span_max(&X[span.i0], span.i1 - span.i0);
+        else
+            X_p[p] = interpolate_bins(X, N, span.i0, span.t);
+    }
+}
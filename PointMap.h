@@ -0,0 +1,46 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+/*
+  ==============================================================================
+
+    PointMap.h
+
+    The mapping of spectrum bins to pixel columns shared by the
+    spectrum line and the waterfall, built by Spectrum::BuildPointMap.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+/*
+    One plotted point of the spectrum. Bins i0 to i1-1 fall in one pixel
+    column and the point is their peak. When i1==i0 the point lies
+    between bins i0 and i0+1, a fraction t of the way, and is
+    interpolated.
+*/
+struct PointSpan
+{
+    int i0;
+    int i1;
+    float t;
+};
+
+// the n points of map from the N values of X, into X_p
+void PoolPoints(const PointSpan *map, int n, const float *X, int N, float *X_p);
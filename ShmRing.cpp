@@ -0,0 +1,159 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+/*
+  ==============================================================================
+
+    ShmRing.cpp
+
+  ==============================================================================
+*/
+
+#include "ShmRing.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <chrono>
+#include <new>
+#include <stdexcept>
+
+ShmRing::ShmRing(uint32_t channels, uint32_t min_frames)
+    :
+    owner(true),
+    channels(channels)
+{
+    capacity = 1;
+    while(capacity < min_frames)
+        capacity <<= 1;
+    mask = capacity - 1;
+    map_size = sizeof(ShmRingHeader)
+        + sizeof(float)*channels*(size_t)capacity;
+
+    // unique per instance, the pid and a clock keep hosts apart
+    static std::atomic<uint32_t> instance(0);
+    uint64_t t = std::chrono::steady_clock::now().time_since_epoch().count();
+    snprintf(name, sizeof(name), "/SignalView-%d-%u-%llx",
+        (int)getpid(), instance++, (unsigned long long)t);
+
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if(fd < 0)
+        throw std::runtime_error("ShmRing: shm_open failed");
+    if(ftruncate(fd, map_size) != 0){
+        close(fd);
+        shm_unlink(name);
+        throw std::runtime_error("ShmRing: ftruncate failed");
+    }
+    void *p = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(p == MAP_FAILED){
+        shm_unlink(name);
+        throw std::bad_alloc();
+    }
+    // touch every page now so that Write never faults them in
+    memset(p, 0, map_size);
+    header = new(p) ShmRingHeader;
+    header->magic = SHM_RING_MAGIC;
+    header->version = SHM_RING_VERSION;
+    header->channels = channels;
+    header->capacity = capacity;
+    header->write_count.store(0, std::memory_order_release);
+    data = (float*)(header + 1);
+}
+
+ShmRing::ShmRing(const char* name)
+    :
+    owner(false)
+{
+    snprintf(ShmRing::name, sizeof(ShmRing::name), "%s", name);
+    int fd = shm_open(name, O_RDONLY, 0);
+    if(fd < 0)
+        throw std::runtime_error("ShmRing: shm_open failed");
+    struct stat st;
+    if(fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ShmRingHeader)){
+        close(fd);
+        throw std::runtime_error("ShmRing: bad size");
+    }
+    map_size = st.st_size;
+    void *p = mmap(NULL, map_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(p == MAP_FAILED)
+        throw std::bad_alloc();
+    header = (ShmRingHeader*)p;
+    channels = header->channels;
+    capacity = header->capacity;
+    if(header->magic != SHM_RING_MAGIC
+        || header->version != SHM_RING_VERSION
+        || channels == 0 || channels > 64
+        || capacity == 0 || (capacity & (capacity - 1))
+        || sizeof(ShmRingHeader)
+            + sizeof(float)*channels*(size_t)capacity > map_size){
+        munmap(p, map_size);
+        throw std::runtime_error("ShmRing: bad header");
+    }
+    mask = capacity - 1;
+    data = (float*)(header + 1);
+}
+
+ShmRing::~ShmRing(void)
+{
+    munmap(header, map_size);
+    if(owner)
+        shm_unlink(name);
+}
+
+void ShmRing::Write(const float * const *in, uint32_t n)
+{
+    uint64_t w = header->write_count.load(std::memory_order_relaxed);
+    uint32_t offset = 0;
+    if(n > capacity){
+        // only the newest frames survive
+        uint32_t skip = n - capacity;
+        offset = skip;
+        w += skip;
+        n = capacity;
+    }
+    while(n > 0){
+        uint32_t i = w & mask;
+        uint32_t m = capacity - i;
+        if(n < m) m = n;
+        for(uint32_t c=0;c<channels;c++){
+            const float *src = in[c] + offset;
+            float *dst = &data[channels*i + c];
+            for(uint32_t k=0;k<m;k++){
+                *dst = *(src++);
+                dst += channels;
+            }
+        }
+        offset += m;
+        w += m;
+        n -= m;
+    }
+    header->write_count.store(w, std::memory_order_release);
+}
+
+const float* ShmRing::GetFrames(uint64_t start, uint64_t n_max, uint32_t &n)
+{
+    uint32_t i = start & mask;
+    uint64_t m = capacity - i;
+    if(n_max < m) m = n_max;
+    n = (uint32_t)m;
+    return &data[channels*(size_t)i];
+}
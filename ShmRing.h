@@ -0,0 +1,86 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+/*
+  ==============================================================================
+
+    ShmRing.h
+
+    Interleaved multichannel ring in POSIX shared memory. The plugin writes
+    every block into it and publishes the total frame count in the
+    header; the UI maps the ring by name and reads from its own cursor.
+    The writer never waits, a reader that falls more than the capacity
+    behind loses frames and can tell how many from the counts.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SHM_RING_MAGIC   0x53565247 // "SVRG"
+#define SHM_RING_VERSION 1
+#define SHM_NAME_LENGTH  64
+
+struct ShmRingHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t channels;
+    uint32_t capacity;  // frames, a power of two
+    // frames written since creation, the write cursor
+    alignas(64) std::atomic<uint64_t> write_count;
+};
+
+class ShmRing
+{
+    char           name[SHM_NAME_LENGTH];
+    bool           owner;
+    size_t         map_size;
+    ShmRingHeader* header;
+    float*         data;
+    uint32_t       channels;
+    uint32_t       capacity;
+    uint32_t       mask;
+
+public:
+    // create a ring of at least min_frames frames of channels samples
+    ShmRing(uint32_t channels, uint32_t min_frames);
+    // map an existing ring read only
+    ShmRing(const char* name);
+    ~ShmRing(void);
+
+    const char* GetName(void) { return name; }
+    uint32_t GetChannels(void) { return channels; }
+    uint32_t GetCapacity(void) { return capacity; }
+    uint64_t GetWriteCount(void)
+    {
+        return header->write_count.load(std::memory_order_acquire);
+    }
+
+    // writer: append n frames from one buffer per channel, does not
+    // allocate or block
+    void Write(const float * const *in, uint32_t n);
+
+    // reader: the contiguous frames from frame start, at most n_max,
+    // returned in n, channels samples per frame
+    const float* GetFrames(uint64_t start, uint64_t n_max, uint32_t &n);
+};
@@ -28,11 +28,13 @@ SignalView::SignalView(
     LV2_Log_Logger logger;
     LV2_Log_Log*   logger_log = NULL;
     map = NULL;
+    schedule = NULL;
 
     const char* missing = lv2_features_query(
         features,
-        LV2_URID__map, &map,        true,
-        LV2_LOG__log,  &logger_log, false,
+        LV2_URID__map,        &map,        true,
+        LV2_LOG__log,         &logger_log, false,
+        LV2_WORKER__schedule, &schedule,   false,
         NULL);
 
     lv2_log_logger_init(&logger, map, logger_log);
@@ -42,6 +44,18 @@ SignalView::SignalView(
         throw std::exception();
     }
 
+    nChannels = signal_view_channels(descriptor->URI);
+    if (nChannels < 1 || nChannels > SIGNAL_VIEW_MAX_CHANNELS) {
+        lv2_log_error(&logger, "SignalView::SignalView unknown plugin <%s>\n", descriptor->URI);
+        throw std::exception();
+    }
+    for (int c = 0; c < SIGNAL_VIEW_MAX_CHANNELS; ++c) {
+        input[c] = NULL;
+        output[c] = NULL;
+    }
+    // plans missing from the wisdom cache are measured by the bundle's tool
+    FFT::SetWisdomTool(bundle_path);
+
     ui_active = false;
     send_settings_to_ui = false;
     SignalView::rate = rate;
@@ -49,6 +63,29 @@ SignalView::SignalView(
     dB_max = 0.0f;
     linFreq = rate/2.0f;
     log = false;
+    window = WINDOW_DEFAULT;
+    fftSize = FFT_SIZE_DEFAULT;
+    overlap = FFT_OVERLAP_DEFAULT;
+    dspAnalysis = false;
+    transport = TRANSPORT_DEFAULT;
+    sample_count = 0;
+    work_pending = false;
+    work_fftSize = 0;
+    work_overlap = 0;
+    work_window = -1;
+
+    if (!schedule) {
+        lv2_log_note(&logger, "SignalView::SignalView no worker, DSP analysis unavailable.\n");
+    }
+
+    send_shm_to_ui = false;
+    shm_active = false;
+    try {
+        shm_ring.reset(new ShmRing(nChannels, (uint32_t)(rate*SHM_RING_SECONDS)));
+    }
+    catch(...) {
+        lv2_log_note(&logger, "SignalView::SignalView no shared memory, using atoms.\n");
+    }
 
     try {
         uris.reset(new SignalViewURIs(map));
@@ -63,61 +100,289 @@ SignalView::SignalView(
 
 void SignalView::connect_port(uint32_t port, void *data)
 {
-    switch((PortIndex)port){
+    switch(port){
     case PORT_CONTROL:
         control = (const LV2_Atom_Sequence*)data;
         break;
     case PORT_NOTIFY:
         notify = (LV2_Atom_Sequence*)data;
         break;
-    case PORT_INPUT0:
-        input[0] = (float*)data;
-        break;
-    case PORT_INPUT1:
-        input[1] = (float*)data;
-        break;
-    case PORT_OUTPUT0:
-        output[0] = (float*)data;
-        break;
-    case PORT_OUTPUT1:
-        output[1] = (float*)data;
-        break;
-    case PORT_NPORTS:
+    default:
+        if(port < PORT_INPUT0 + (uint32_t)nChannels){
+            input[port - PORT_INPUT0] = (float*)data;
+        }else if(port < PORT_INPUT0 + 2*(uint32_t)nChannels){
+            output[port - PORT_INPUT0 - nChannels] = (float*)data;
+        }
         break;
     }
 }
 
-void SignalView::tx_rawaudio(
-    const size_t  n_samples,
-    const float*  data0,
-    const float*  data1)
+/*
+    Bytes the forge writes around the samples of one RawAudio chunk: the
+    event time, the object header, the int and long properties, the data
+    property header and up to 7 bytes of padding after the data.
+*/
+static uint32_t raw_chunk_overhead(const TransportFormat format)
 {
-    LV2_Atom_Forge_Frame frame;
+    const uint32_t prop_int = sizeof(LV2_Atom_Property_Body) + 8;
+    uint32_t size = sizeof(int64_t) + sizeof(LV2_Atom_Object)
+        + 3*prop_int + 7;
+    if(format==TRANSPORT_FLOAT32){
+        size += sizeof(LV2_Atom_Property_Body) + sizeof(LV2_Atom_Vector_Body);
+    }else{
+        size += sizeof(LV2_Atom_Property_Body);
+        if(format==TRANSPORT_INT16){
+            size += prop_int;
+        }
+    }
+    return size;
+}
 
-    // Forge container object of type 'RawAudio'
-    lv2_atom_forge_frame_time(&forge, 0);
-    lv2_atom_forge_object(&forge, &frame, 0, uris->RawAudio);
+/*
+    Send the block as RawAudio chunks of at most RAW_CHUNK_FRAMES frames,
+    each sized to fit in what is left of the notify buffer. Frames that
+    do not fit are dropped; the sample count of each chunk lets the UI
+    detect the gap. A chunk the forge cannot complete is rolled back.
+*/
+void SignalView::tx_rawaudio(const size_t n_samples)
+{
+    const TransportFormat format = (TransportFormat)transport;
+    const size_t frame_size = nChannels*Transport::SampleSize(format);
+    const uint32_t overhead = raw_chunk_overhead(format);
+    size_t i0 = 0;
+    while(i0 < n_samples){
+        const uint32_t space = forge.size - forge.offset;
+        if(space < overhead + frame_size){
+            break;
+        }
+        size_t n = (space - overhead)/frame_size;
+        if(n > RAW_CHUNK_FRAMES) n = RAW_CHUNK_FRAMES;
+        if(n > n_samples - i0) n = n_samples - i0;
+
+        // state to roll back to if the chunk does not fit after all
+        LV2_Atom* seq = lv2_atom_forge_deref(&forge, seq_frame.ref);
+        const uint32_t seq_size = seq->size;
+        const uint32_t offset = forge.offset;
+        LV2_Atom_Forge_Frame* stack = forge.stack;
+
+        LV2_Atom_Forge_Frame frame;
+
+        // Forge container object of type 'RawAudio'
+        bool ok = lv2_atom_forge_frame_time(&forge, 0)
+            && lv2_atom_forge_object(&forge, &frame, 0, uris->RawAudio);
+
+        // Add integer 'channelID' property
+        ok = ok && lv2_atom_forge_key(&forge, uris->nChannels)
+            && lv2_atom_forge_int(&forge, nChannels);
+
+        // Add the count of the first sample of the chunk
+        ok = ok && lv2_atom_forge_key(&forge, uris->sampleCount)
+            && lv2_atom_forge_long(&forge, sample_count + (int64_t)i0);
+
+        // interleave the channels into frames
+        for(int c=0;c<nChannels;c++){
+            float *dst = vec_buffer + c;
+            const float *src = input[c] + i0;
+            for(size_t i=0;i<n;i++){
+                *dst = *(src++);
+                dst += nChannels;
+            }
+        }
+
+        ok = ok && lv2_atom_forge_key(&forge, uris->audioFormat)
+            && lv2_atom_forge_int(&forge, format);
+
+        if(format==TRANSPORT_FLOAT32){
+            // Add vector of floats 'audioData' property
+            ok = ok && lv2_atom_forge_key(&forge, uris->audioData)
+                && lv2_atom_forge_vector(&forge, sizeof(float),
+                    uris->atom_Float, n*nChannels, vec_buffer);
+        }else if(ok){
+            // Add the 16 bit samples as a chunk
+            int exponent = Transport::Encode(format, vec_buffer, n*nChannels, enc_buffer);
+            if(format==TRANSPORT_INT16){
+                ok = lv2_atom_forge_key(&forge, uris->blockExponent)
+                    && lv2_atom_forge_int(&forge, exponent);
+            }
+            const uint32_t size = n*nChannels*sizeof(uint16_t);
+            ok = ok && lv2_atom_forge_key(&forge, uris->audioData)
+                && lv2_atom_forge_atom(&forge, size, uris->atom_Chunk)
+                && lv2_atom_forge_write(&forge, enc_buffer, size);
+        }
+
+        if(!ok){
+            // drop the partial event and everything after it
+            forge.stack = stack;
+            forge.offset = offset;
+            seq->size = seq_size;
+            break;
+        }
+
+        // Close off object
+        lv2_atom_forge_pop(&forge, &frame);
 
-    // Add integer 'channelID' property
-    lv2_atom_forge_key(&forge, uris->nChannels);
-    lv2_atom_forge_int(&forge, 2);
+        i0 += n;
+    }
+}
+
+/*
+    Bytes the forge writes around the spectra and the envelope of one
+    Spectra object: the event time, the object header, the two int
+    properties, the chunk and vector property headers and up to 7 bytes
+    of padding after each of the chunk and the vector.
+*/
+static uint32_t spectra_overhead(void)
+{
+    const uint32_t prop_int = sizeof(LV2_Atom_Property_Body) + 8;
+    return sizeof(int64_t) + sizeof(LV2_Atom_Object) + 2*prop_int
+        + sizeof(LV2_Atom_Property_Body) + 7
+        + sizeof(LV2_Atom_Property_Body) + sizeof(LV2_Atom_Vector_Body) + 7;
+}
 
-    float *dst = vec_buffer;
-    const float *src0 = data0;
-    const float *src1 = data1;
-    for(int i=0;i<n_samples;i++){
-        *(dst++) = *(src0++);
-        *(dst++) = *(src1++);
+/*
+    Send the spectra of the last frame decimated to what is left of the
+    notify buffer. An object the forge cannot complete is rolled back.
+*/
+void SignalView::tx_spectra(void)
+{
+    const uint32_t overhead = spectra_overhead();
+    const uint32_t envelope_size =
+        SPECTRA_ENVELOPE_POINTS*2*nChannels*sizeof(float);
+    const uint32_t space = forge.size - forge.offset;
+    if(space < overhead + envelope_size + 2*nChannels*sizeof(uint16_t)){
+        return;
     }
 
-    // Add vector of floats 'audioData' property
-    lv2_atom_forge_key(&forge, uris->audioData);
-    lv2_atom_forge_vector(
-        &forge, sizeof(float), uris->atom_Float, n_samples*2, vec_buffer);
+    // decimate the spectra to what is left of the notify buffer
+    const int max_points =
+        (space - overhead - envelope_size)/(nChannels*sizeof(uint16_t));
+    const int n_points = analysis->Compute(max_points);
+    const uint32_t spectra_size = n_points*nChannels*sizeof(uint16_t);
+
+    // state to roll back to if the object does not fit after all
+    LV2_Atom* seq = lv2_atom_forge_deref(&forge, seq_frame.ref);
+    const uint32_t seq_size = seq->size;
+    const uint32_t offset = forge.offset;
+    LV2_Atom_Forge_Frame* stack = forge.stack;
+
+    LV2_Atom_Forge_Frame frame;
+
+    // Forge container object of type 'Spectra'
+    bool ok = lv2_atom_forge_frame_time(&forge, 0)
+        && lv2_atom_forge_object(&forge, &frame, 0, uris->Spectra);
+
+    ok = ok && lv2_atom_forge_key(&forge, uris->nChannels)
+        && lv2_atom_forge_int(&forge, nChannels);
+
+    ok = ok && lv2_atom_forge_key(&forge, uris->nPoints)
+        && lv2_atom_forge_int(&forge, n_points);
+
+    // Add the quantised spectra as a chunk of uint16
+    ok = ok && lv2_atom_forge_key(&forge, uris->spectraData)
+        && lv2_atom_forge_atom(&forge, spectra_size, uris->atom_Chunk)
+        && lv2_atom_forge_write(&forge, analysis->GetSpectra(), spectra_size);
+
+    // Add the (min,max) envelope of the frame
+    ok = ok && lv2_atom_forge_key(&forge, uris->envelopeData)
+        && lv2_atom_forge_vector(
+            &forge, sizeof(float), uris->atom_Float,
+            SPECTRA_ENVELOPE_POINTS*2*nChannels, analysis->GetEnvelope());
+
+    if(!ok){
+        // drop the partial event
+        forge.stack = stack;
+        forge.offset = offset;
+        seq->size = seq_size;
+        return;
+    }
 
     // Close off object
     lv2_atom_forge_pop(&forge, &frame);
+}
+
+// Tell the UI the name of the shared memory ring
+void SignalView::tx_shm_ring(void)
+{
+    const char* name = shm_ring->GetName();
+    LV2_Atom_Forge_Frame frame;
+    lv2_atom_forge_frame_time(&forge, 0);
+    lv2_atom_forge_object(&forge, &frame, 0, uris->ShmRing);
+    lv2_atom_forge_key(&forge, uris->shmName);
+    lv2_atom_forge_string(&forge, name, strlen(name));
+    lv2_atom_forge_pop(&forge, &frame);
+}
+
+/*
+    Ask the worker for an analysis matching the current settings. A
+    failed request is not repeated until the settings change.
+*/
+void SignalView::update_analysis(void)
+{
+    if(!schedule || work_pending)
+        return;
+
+    if(analysis_retired){
+        WorkMessage msg = {WORK_FREE_ANALYSIS, 0, 0, 0, analysis_retired.get()};
+        if(schedule->schedule_work(schedule->handle, sizeof(msg), &msg)
+            != LV2_WORKER_SUCCESS){
+            return;
+        }
+        analysis_retired.release();
+    }
 
+    if(analysis && analysis->Matches(fftSize, overlap, window))
+        return;
+    if(work_fftSize==fftSize && work_overlap==overlap && work_window==window)
+        return;
+
+    WorkMessage msg = {WORK_CREATE_ANALYSIS, fftSize, overlap, window, nullptr};
+    if(schedule->schedule_work(schedule->handle, sizeof(msg), &msg)
+        == LV2_WORKER_SUCCESS){
+        work_pending = true;
+        work_fftSize = fftSize;
+        work_overlap = overlap;
+        work_window = window;
+    }
+}
+
+LV2_Worker_Status SignalView::work(
+    LV2_Worker_Respond_Function respond,
+    LV2_Worker_Respond_Handle   handle,
+    uint32_t                    size,
+    const void*                 data)
+{
+    if(size!=sizeof(WorkMessage)){
+        return LV2_WORKER_ERR_UNKNOWN;
+    }
+    WorkMessage msg = *(const WorkMessage*)data;
+    if(msg.type==WORK_FREE_ANALYSIS){
+        delete msg.analysis;
+        return LV2_WORKER_SUCCESS;
+    }
+    try {
+        msg.analysis = new DSPAnalysis(
+            msg.fftSize, nChannels, msg.overlap, msg.window, rate);
+    }
+    catch(...) {
+        msg.analysis = nullptr;
+    }
+    // a null analysis still clears work_pending
+    return respond(handle, sizeof(msg), &msg);
+}
+
+LV2_Worker_Status SignalView::work_response(uint32_t size, const void* data)
+{
+    if(size!=sizeof(WorkMessage)){
+        return LV2_WORKER_ERR_UNKNOWN;
+    }
+    const WorkMessage* msg = (const WorkMessage*)data;
+    work_pending = false;
+    if(msg->analysis){
+        // the old analysis is freed by the worker on the next run
+        analysis_retired.reset(analysis.release());
+        analysis.reset(msg->analysis);
+    }
+    return LV2_WORKER_SUCCESS;
 }
 
 void SignalView::run(uint32_t n_samples)
@@ -150,11 +415,26 @@ void SignalView::run(uint32_t n_samples)
         lv2_atom_forge_float(&forge, linFreq);
         lv2_atom_forge_key(&forge, uris->ui_log);
         lv2_atom_forge_bool(&forge, (int32_t)log);
+        lv2_atom_forge_key(&forge, uris->ui_window);
+        lv2_atom_forge_int(&forge, window);
+        lv2_atom_forge_key(&forge, uris->ui_fftSize);
+        lv2_atom_forge_int(&forge, fftSize);
+        lv2_atom_forge_key(&forge, uris->ui_overlap);
+        lv2_atom_forge_int(&forge, overlap);
+        lv2_atom_forge_key(&forge, uris->ui_dspAnalysis);
+        lv2_atom_forge_bool(&forge, (int32_t)dspAnalysis);
+        lv2_atom_forge_key(&forge, uris->ui_transport);
+        lv2_atom_forge_int(&forge, transport);
         lv2_atom_forge_key(&forge, uris->param_sampleRate);
         lv2_atom_forge_float(&forge, (float)rate);
         lv2_atom_forge_pop(&forge, &frame);
     }
 
+    if (send_shm_to_ui) {
+        send_shm_to_ui = false;
+        tx_shm_ring();
+    }
+
     // Process incoming events from GUI
     if (control) {
         const LV2_Atom_Event* ev = lv2_atom_sequence_begin(&control->body);
@@ -167,23 +447,47 @@ void SignalView::run(uint32_t n_samples)
                 if (obj->body.otype == uris->ui_On) {
                     // If the object is a ui-on, the UI was activated
                     ui_active           = true;
+                    // offer the ring, atoms are used until it is mapped
+                    shm_active          = false;
+                    send_shm_to_ui      = shm_ring != nullptr;
                 } else if (obj->body.otype == uris->ui_SendState) {
                     send_settings_to_ui = true;
                 } else if (obj->body.otype == uris->ui_Off) {
                     // If the object is a ui-off, the UI was closed
                     ui_active = false;
+                    shm_active = false;
+                } else if (obj->body.otype == uris->ui_ShmAck) {
+                    // The UI mapped the ring, check it is this one
+                    const LV2_Atom* name_atom = NULL;
+                    lv2_atom_object_get(obj, uris->shmName, &name_atom, 0);
+                    if (shm_ring && name_atom && name_atom->type == uris->atom_String
+                        && name_atom->size > 1
+                        && !strncmp((const char*)(name_atom + 1),
+                            shm_ring->GetName(), name_atom->size)) {
+                        shm_active = true;
+                    }
                 } else if (obj->body.otype == uris->ui_State) {
                     // If the object is a ui-state, it's the current UI settings
                     const LV2_Atom* dB_min_atom = NULL;
                     const LV2_Atom* dB_max_atom = NULL;
                     const LV2_Atom* linFreq_atom = NULL;
                     const LV2_Atom* log_atom = NULL;
+                    const LV2_Atom* window_atom = NULL;
+                    const LV2_Atom* fftSize_atom = NULL;
+                    const LV2_Atom* overlap_atom = NULL;
+                    const LV2_Atom* dspAnalysis_atom = NULL;
+                    const LV2_Atom* transport_atom = NULL;
                     lv2_atom_object_get(
                         obj,
                         uris->ui_dB_min, &dB_min_atom,
                         uris->ui_dB_max, &dB_max_atom,
                         uris->ui_linFreq, &linFreq_atom,
                         uris->ui_log, &log_atom,
+                        uris->ui_window, &window_atom,
+                        uris->ui_fftSize, &fftSize_atom,
+                        uris->ui_overlap, &overlap_atom,
+                        uris->ui_dspAnalysis, &dspAnalysis_atom,
+                        uris->ui_transport, &transport_atom,
                         0);
                     if(dB_min_atom) {
                         dB_min = ((const LV2_Atom_Float*)dB_min_atom)->body;
@@ -197,6 +501,21 @@ void SignalView::run(uint32_t n_samples)
                     if(log_atom) {
                         log = ((const LV2_Atom_Bool*)log_atom)->body != 0;
                     }
+                    if(window_atom) {
+                        window = FFTWindow::Validate(((const LV2_Atom_Int*)window_atom)->body);
+                    }
+                    if(fftSize_atom) {
+                        fftSize = FFT::ValidateSize(((const LV2_Atom_Int*)fftSize_atom)->body);
+                    }
+                    if(overlap_atom) {
+                        overlap = FFT::ValidateOverlap(((const LV2_Atom_Int*)overlap_atom)->body);
+                    }
+                    if(dspAnalysis_atom) {
+                        dspAnalysis = ((const LV2_Atom_Bool*)dspAnalysis_atom)->body != 0;
+                    }
+                    if(transport_atom) {
+                        transport = Transport::Validate(((const LV2_Atom_Int*)transport_atom)->body);
+                    }
                 }
             }
             ev = lv2_atom_sequence_next(ev);
@@ -205,10 +524,26 @@ void SignalView::run(uint32_t n_samples)
 
     // Process audio data
     if (ui_active) {
-        // If UI is active, send raw audio data to UI
-        tx_rawaudio(n_samples, input[0], input[1]);
+        if (dspAnalysis) {
+            update_analysis();
+        }
+        if (dspAnalysis && analysis
+            && analysis->Matches(fftSize, overlap, window)) {
+            // Analyse here and send spectra at the display rate
+            analysis->Process(input, n_samples);
+            if (analysis->IsReady()) {
+                tx_spectra();
+            }
+        } else if (shm_active) {
+            // The UI reads the ring directly, no atoms needed
+            shm_ring->Write(input, n_samples);
+        } else {
+            // If UI is active, send raw audio data to UI
+            tx_rawaudio(n_samples);
+        }
+        sample_count += n_samples;
     }
-    for (uint32_t c = 0; c < 2; ++c) {
+    for (int c = 0; c < nChannels; ++c) {
         // If not processing audio in-place, forward audio
         if (input[c] != output[c]) {
             memcpy(output[c], input[c], sizeof(float) * n_samples);
@@ -254,6 +589,42 @@ LV2_State_Status SignalView::state_save(
           uris->atom_Bool,
           LV2_STATE_IS_POD);
 
+    store(handle,
+          uris->ui_window,
+          (void*)&window,
+          sizeof(int32_t),
+          uris->atom_Int,
+          LV2_STATE_IS_POD);
+
+    store(handle,
+          uris->ui_fftSize,
+          (void*)&fftSize,
+          sizeof(int32_t),
+          uris->atom_Int,
+          LV2_STATE_IS_POD);
+
+    store(handle,
+          uris->ui_overlap,
+          (void*)&overlap,
+          sizeof(int32_t),
+          uris->atom_Int,
+          LV2_STATE_IS_POD);
+
+    int32_t dspAnalysis_i = dspAnalysis;
+    store(handle,
+          uris->ui_dspAnalysis,
+          (void*)&dspAnalysis_i,
+          sizeof(int32_t),
+          uris->atom_Bool,
+          LV2_STATE_IS_POD);
+
+    store(handle,
+          uris->ui_transport,
+          (void*)&transport,
+          sizeof(int32_t),
+          uris->atom_Int,
+          LV2_STATE_IS_POD);
+
     return LV2_STATE_SUCCESS;
 }
 
@@ -295,6 +666,41 @@ LV2_State_Status SignalView::state_restore(
         send_settings_to_ui = true;
     }
 
+    const void *window_p =
+        retrieve(handle, uris->ui_window, &size, &type, &valflags);
+    if(window_p && size==sizeof(int32_t) && type==uris->atom_Int) {
+        window = FFTWindow::Validate(*((const int32_t*)window_p));
+        send_settings_to_ui = true;
+    }
+
+    const void *fftSize_p =
+        retrieve(handle, uris->ui_fftSize, &size, &type, &valflags);
+    if(fftSize_p && size==sizeof(int32_t) && type==uris->atom_Int) {
+        fftSize = FFT::ValidateSize(*((const int32_t*)fftSize_p));
+        send_settings_to_ui = true;
+    }
+
+    const void *overlap_p =
+        retrieve(handle, uris->ui_overlap, &size, &type, &valflags);
+    if(overlap_p && size==sizeof(int32_t) && type==uris->atom_Int) {
+        overlap = FFT::ValidateOverlap(*((const int32_t*)overlap_p));
+        send_settings_to_ui = true;
+    }
+
+    const void *dspAnalysis_p =
+        retrieve(handle, uris->ui_dspAnalysis, &size, &type, &valflags);
+    if(dspAnalysis_p && size==sizeof(int32_t) && type==uris->atom_Bool) {
+        dspAnalysis = *((const int32_t*)dspAnalysis_p) != 0;
+        send_settings_to_ui = true;
+    }
+
+    const void *transport_p =
+        retrieve(handle, uris->ui_transport, &size, &type, &valflags);
+    if(transport_p && size==sizeof(int32_t) && type==uris->atom_Int) {
+        transport = Transport::Validate(*((const int32_t*)transport_p));
+        send_settings_to_ui = true;
+    }
+
     return LV2_STATE_SUCCESS;
 }
 
@@ -360,33 +766,94 @@ state_restore(LV2_Handle                  instance,
     return LV2_STATE_SUCCESS;
 }
 
+static LV2_Worker_Status
+work(LV2_Handle                  instance,
+     LV2_Worker_Respond_Function respond,
+     LV2_Worker_Respond_Handle   handle,
+     uint32_t                    size,
+     const void*                 data)
+{
+    SignalView* m = (SignalView*) instance;
+    if(m){
+        return m->work(respond, handle, size, data);
+    }
+    return LV2_WORKER_ERR_UNKNOWN;
+}
+
+static LV2_Worker_Status
+work_response(LV2_Handle instance, uint32_t size, const void* data)
+{
+    SignalView* m = (SignalView*) instance;
+    if(m){
+        return m->work_response(size, data);
+    }
+    return LV2_WORKER_ERR_UNKNOWN;
+}
+
 static const void*
 extension_data(const char* uri)
 {
     static const LV2_State_Interface state = {state_save, state_restore};
+    static const LV2_Worker_Interface worker = {work, work_response, NULL};
     if (!strcmp(uri, LV2_STATE__interface)) {
         return &state;
     }
+    if (!strcmp(uri, LV2_WORKER__interface)) {
+        return &worker;
+    }
     return NULL;
 }
 
-static const LV2_Descriptor descriptor =
+// one descriptor per channel count, told apart by URI in the constructor
+static const LV2_Descriptor descriptors[] =
 {
-    SIGNAL_VIEW_URI,
-    instantiate,
-    connect_port,
-    NULL,
-    run,
-    NULL,
-    cleanup,
-    extension_data
+    {
+        SIGNAL_VIEW_URI,
+        instantiate,
+        connect_port,
+        NULL,
+        run,
+        NULL,
+        cleanup,
+        extension_data
+    },
+    {
+        SIGNAL_VIEW_MONO_URI,
+        instantiate,
+        connect_port,
+        NULL,
+        run,
+        NULL,
+        cleanup,
+        extension_data
+    },
+    {
+        SIGNAL_VIEW_51_URI,
+        instantiate,
+        connect_port,
+        NULL,
+        run,
+        NULL,
+        cleanup,
+        extension_data
+    },
+    {
+        SIGNAL_VIEW_71_URI,
+        instantiate,
+        connect_port,
+        NULL,
+        run,
+        NULL,
+        cleanup,
+        extension_data
+    }
 };
 
 LV2_SYMBOL_EXPORT const LV2_Descriptor*
 lv2_descriptor(uint32_t index)
 {
-    if(index==0){
-        return &descriptor;
+    if(index < sizeof(descriptors)/sizeof(descriptors[0])){
+        return &descriptors[index];
     } else {
         return nullptr;
     }
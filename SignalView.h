@@ -18,6 +18,11 @@
 */
 
 #include "uris.h"
+#include "FFTWindow.h"
+#include "FFT.h"
+#include "DSPAnalysis.h"
+#include "Transport.h"
+#include "ShmRing.h"
 
 #include <lv2/atom/atom.h>
 #include <lv2/atom/forge.h>
@@ -28,6 +33,7 @@
 #include <lv2/log/logger.h>
 #include <lv2/state/state.h>
 #include <lv2/urid/urid.h>
+#include <lv2/worker/worker.h>
 
 #include <stdbool.h>
 #include <stdint.h>
@@ -36,11 +42,29 @@
 #include <string.h>
 #include <memory>
 
+// length of the shared memory ring
+#define SHM_RING_SECONDS 0.5
+
+enum WorkType {
+    WORK_CREATE_ANALYSIS = 0,
+    WORK_FREE_ANALYSIS
+};
+
+// message passed through the worker, by value
+struct WorkMessage {
+    WorkType     type;
+    int32_t      fftSize;
+    int32_t      overlap;
+    int32_t      window;
+    DSPAnalysis* analysis;
+};
+
 class SignalView
 {
     // Port buffers
-    float *input[2];
-    float *output[2];
+    int    nChannels;
+    float *input[SIGNAL_VIEW_MAX_CHANNELS];
+    float *output[SIGNAL_VIEW_MAX_CHANNELS];
     const LV2_Atom_Sequence* control;
     LV2_Atom_Sequence*       notify;
 
@@ -49,8 +73,17 @@ class SignalView
     std::unique_ptr<SignalViewURIs> uris;
     LV2_Atom_Forge                  forge;
     LV2_Atom_Forge_Frame            seq_frame;
+    LV2_Worker_Schedule*            schedule;
+
+    float vec_buffer[RAW_CHUNK_FRAMES*SIGNAL_VIEW_MAX_CHANNELS];
+    uint16_t enc_buffer[RAW_CHUNK_FRAMES*SIGNAL_VIEW_MAX_CHANNELS];
+    // samples seen while the UI is active, the UI detects gaps with it
+    int64_t sample_count;
 
-    float vec_buffer[32000];
+    // shared memory transport, used once the UI has mapped the ring
+    std::unique_ptr<ShmRing> shm_ring;
+    bool send_shm_to_ui;
+    bool shm_active;
 
     double rate;
 
@@ -61,6 +94,21 @@ class SignalView
     float dB_max;
     bool  log;
     float linFreq;
+    int32_t window;
+    int32_t fftSize;
+    int32_t overlap;
+    bool  dspAnalysis;
+    int32_t transport;
+
+    // DSP side analysis, built and freed by the worker
+    std::unique_ptr<DSPAnalysis> analysis;
+    std::unique_ptr<DSPAnalysis> analysis_retired;
+    bool    work_pending;
+    int32_t work_fftSize;
+    int32_t work_overlap;
+    int32_t work_window;
+
+    void update_analysis(void);
 
 public:
     SignalView(
@@ -70,11 +118,16 @@ public:
         const LV2_Feature* const* features);
 
     void connect_port(uint32_t port, void *data);
-    void tx_rawaudio(
-        const size_t  n_samples,
-        const float*  data0,
-        const float*  data1);
+    void tx_rawaudio(const size_t n_samples);
+    void tx_spectra(void);
+    void tx_shm_ring(void);
     void run(uint32_t n_samples);
+    LV2_Worker_Status work(
+        LV2_Worker_Respond_Function respond,
+        LV2_Worker_Respond_Handle   handle,
+        uint32_t                    size,
+        const void*                 data);
+    LV2_Worker_Status work_response(uint32_t size, const void* data);
     LV2_State_Status state_save(
         LV2_State_Store_Function  store,
         LV2_State_Handle          handle,
@@ -87,12 +140,9 @@ public:
         const LV2_Feature* const*   features);
 };
 
+// nChannels audio inputs from PORT_INPUT0, then nChannels outputs
 enum PortIndex {
     PORT_CONTROL = 0,
     PORT_NOTIFY  = 1,
-    PORT_INPUT0  = 2,
-    PORT_INPUT1  = 3,
-    PORT_OUTPUT0 = 4,
-    PORT_OUTPUT1 = 5,
-    PORT_NPORTS  = 6
+    PORT_INPUT0  = 2
 };
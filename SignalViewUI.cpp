@@ -30,7 +30,8 @@ SignalViewUI::SignalViewUI(
     :
     write(write_function),
     controller(controller),
-    bundle_path(bundle_path)
+    bundle_path(bundle_path),
+    shm_sem(1)
 {
     parentXWindow = nullptr;
     map = nullptr;
@@ -48,6 +49,12 @@ SignalViewUI::SignalViewUI(
         throw std::exception();
     }
 
+    nChannels = signal_view_channels(plugin_uri);
+    if (nChannels < 1 || nChannels > SIGNAL_VIEW_MAX_CHANNELS) {
+        printf("Unknown plugin <%s>\n", plugin_uri);
+        throw std::exception();
+    }
+
     uris.reset(new SignalViewURIs(map));
     lv2_atom_forge_init(&forge, map);
     lv2_log_logger_init(&logger, map, logger_log);
@@ -61,9 +68,33 @@ SignalViewUI::SignalViewUI(
     dB_max = 0.0f;
     linFreq = rate/2.0f;
     log = false;
+    window = WINDOW_DEFAULT;
+    fftSize = FFT_SIZE_DEFAULT;
+    overlap = FFT_OVERLAP_DEFAULT;
+    dspAnalysis = false;
+    interpolate = true;
+    history = WATERFALL_HISTORY_DEFAULT;
+    paused = false;
+    transport = TRANSPORT_DEFAULT;
     mousing = false;
+    rx_buffer.reset(new float[RAW_CHUNK_FRAMES*nChannels]);
+    shm_pending = false;
+    shm_read = 0;
 
     time_last = std::chrono::steady_clock::now();
+    stats_time_last = time_last;
+    stats_produced_last = 0;
+    stats_consumed_last = 0;
+    stats_graph_ns_last = 0;
+    stats_graph_frames_last = 0;
+    rx_bytes_raw = 0;
+    rx_bytes_spectra = 0;
+    stats_rx_raw_last = 0;
+    stats_rx_spectra_last = 0;
+    rx_sync = false;
+    rx_sample_next = 0;
+    rx_dropped = 0;
+    stats_dropped_last = 0;
 
     std::function<void()> deferred_task = std::bind(ui_thread_func, this);
 
@@ -185,6 +216,12 @@ void SignalViewUI::setSpectrum(void)
             spectrum->SetWidth(linFreq);
         }
         spectrum->SetFrequency(log);
+        spectrum->SetWindow(window);
+        spectrum->SetFFT(fftSize, overlap);
+        spectrum->SetInterpolate(interpolate);
+        spectrum->SetTrigger(trigger);
+        spectrum->SetWaterfallHistory(history);
+        spectrum->SetWaterfallPaused(paused);
     }
 }
 
@@ -203,13 +240,16 @@ PuglStatus SignalViewUI::setupGL(void)
     lv2_log_note(&logger, "SignalViewUI frame_rate=%f\n", frame_rate);
 
     // Create a new SignalViewGL
+    std::chrono::time_point<std::chrono::steady_clock>
+        time_start = std::chrono::steady_clock::now();
     try {
         spectrum.reset(
             new Spectrum(
-                (int)(rate / 10.0f),
+                fftSize,
+                nChannels,
                 rate,
                 frame_rate,
-                3,
+                overlap,
                 bundle_path));
     }
     catch(const std::bad_alloc& e){
@@ -236,6 +276,15 @@ PuglStatus SignalViewUI::setupGL(void)
             return PUGL_REALIZE_FAILED;
         }
         setSpectrum();
+        stats_time_last = std::chrono::steady_clock::now();
+        std::chrono::duration<double> diff = stats_time_last - time_start;
+        lv2_log_note(&logger, "SignalViewUI spectrum ready in %.1f ms, fft plan %s\n",
+            diff.count()*1000.0,
+            spectrum->GetWisdomHit() ? "from wisdom" : "estimated, measuring");
+        stats_produced_last = 0;
+        stats_consumed_last = 0;
+        stats_graph_ns_last = 0;
+        stats_graph_frames_last = 0;
     }
 
     // enable data from the plugin
@@ -281,7 +330,127 @@ void SignalViewUI::onExpose(void)
     glViewport(0, 0, width, height);
     // draw the SignalViewGL
     // printf("SignalViewUI::onExpose\n");
-    if(spectrum) spectrum->Render();
+    mapShmRing();
+    if(spectrum){
+        if(shm_ring) readShmRing();
+        spectrum->SetDropped(rx_dropped);
+        spectrum->Render();
+    }
+
+    logStats();
+}
+
+/*
+    Map a ring offered by the plugin and acknowledge it. Until the
+    acknowledgement arrives the plugin keeps sending atoms; if mapping
+    fails it simply continues to.
+*/
+void SignalViewUI::mapShmRing(void)
+{
+    char name[SHM_NAME_LENGTH];
+    shm_sem.wait();
+    bool pending = shm_pending;
+    shm_pending = false;
+    memcpy(name, shm_pending_name, sizeof(name));
+    shm_sem.post();
+    if(!pending)
+        return;
+
+    try {
+        shm_ring.reset(new ShmRing(name));
+    }
+    catch(...) {
+        lv2_log_note(&logger, "SignalViewUI can't map %s, using atoms.\n", name);
+        shm_ring.reset(nullptr);
+        return;
+    }
+    if(shm_ring->GetChannels() != (uint32_t)nChannels){
+        lv2_log_note(&logger, "SignalViewUI %s has %u channels, using atoms.\n",
+            name, shm_ring->GetChannels());
+        shm_ring.reset(nullptr);
+        return;
+    }
+    shm_read = shm_ring->GetWriteCount();
+    rx_sync = false;
+    send_ui_shm_ack();
+    lv2_log_note(&logger, "SignalViewUI reading audio from %s\n", name);
+}
+
+/*
+    Feed the frames written since the last read straight from the ring.
+    Frames overwritten before or while they were read count as dropped.
+*/
+void SignalViewUI::readShmRing(void)
+{
+    const uint64_t capacity = shm_ring->GetCapacity();
+    uint64_t w = shm_ring->GetWriteCount();
+    if(w - shm_read > capacity){
+        rx_dropped += w - shm_read - capacity;
+        shm_read = w - capacity;
+    }
+    const uint64_t start = shm_read;
+    while(shm_read < w){
+        uint32_t n;
+        const float *frames = shm_ring->GetFrames(shm_read, w - shm_read, n);
+        spectrum->EvaluateBlock(frames, n);
+        shm_read += n;
+    }
+    uint64_t w_after = shm_ring->GetWriteCount();
+    if(w_after - start > capacity){
+        rx_dropped += w_after - start - capacity;
+    }
+}
+
+void SignalViewUI::logStats(void)
+{
+    std::chrono::time_point<std::chrono::steady_clock>
+        time_now = std::chrono::steady_clock::now();
+    std::chrono::duration<double> diff = time_now - stats_time_last;
+    if(diff.count() < 1.0 || !spectrum)
+        return;
+
+    uint64_t produced;
+    uint64_t consumed;
+    spectrum->GetAnalysisCounts(produced, consumed);
+    lv2_log_trace(&logger,
+        "SignalViewUI analysis frames/s produced:%.1f consumed:%.1f\n",
+        (produced - stats_produced_last)/diff.count(),
+        (consumed - stats_consumed_last)/diff.count());
+    stats_produced_last = produced;
+    stats_consumed_last = consumed;
+
+    // CPU time of the graph classes per rendered frame
+    uint64_t graph_ns;
+    uint64_t graph_frames;
+    spectrum->GetGraphTime(graph_ns, graph_frames);
+    if(graph_frames > stats_graph_frames_last){
+        lv2_log_trace(&logger,
+            "SignalViewUI graph time/frame:%.1f us\n",
+            (graph_ns - stats_graph_ns_last)*1e-3
+                /(graph_frames - stats_graph_frames_last));
+    }
+    stats_graph_ns_last = graph_ns;
+    stats_graph_frames_last = graph_frames;
+
+    // atom traffic from the plugin, raw audio or DSP side spectra
+    uint64_t rx_raw = rx_bytes_raw;
+    uint64_t rx_spectra = rx_bytes_spectra;
+    lv2_log_trace(&logger,
+        "SignalViewUI atom bytes/s raw:%.0f spectra:%.0f\n",
+        (rx_raw - stats_rx_raw_last)/diff.count(),
+        (rx_spectra - stats_rx_spectra_last)/diff.count());
+    stats_rx_raw_last = rx_raw;
+    stats_rx_spectra_last = rx_spectra;
+
+    uint64_t dropped = rx_dropped;
+    if(dropped != stats_dropped_last){
+        lv2_log_warning(&logger,
+            "SignalViewUI dropped samples:%llu total:%llu\n",
+            (unsigned long long)(dropped - stats_dropped_last),
+            (unsigned long long)dropped);
+    }
+    stats_dropped_last = dropped;
+    stats_time_last = time_now;
 }
 
 void SignalViewUI::onScroll(int y, int dy)
@@ -304,6 +473,9 @@ void SignalViewUI::onScroll(int y, int dy)
         }
         if(spectrum) spectrum->SetdBLimits(dB_min, dB_max);
         send_ui_state();
+    }else if(y>h2 && paused){
+        // back through the waterfall history, 8 lines a step
+        if(spectrum) spectrum->ScrollWaterfall(dy*8);
     }
 }
 
@@ -349,6 +521,97 @@ void SignalViewUI::onMotion(const PuglMotionEvent* e)
     }
 }
 
+void SignalViewUI::onKeyPress(const PuglKeyEvent* e)
+{
+    if(e->key == 'q' || e->key == PUGL_KEY_ESCAPE){
+        quit = true;
+    }else if(e->key == 'w'){
+        // cycle through the analysis windows
+        window = (window + 1) % WINDOW_NTYPES;
+        if(spectrum) spectrum->SetWindow(window);
+        lv2_log_note(&logger, "SignalViewUI window:%s\n",
+            FFTWindow::Name((WindowType)window));
+        send_ui_state();
+    }else if(e->key == '[' || e->key == ']'){
+        // halve or double the FFT size
+        fftSize = FFT::ValidateSize(e->key == ']' ? fftSize*2 : fftSize/2);
+        if(spectrum) spectrum->SetFFT(fftSize, overlap);
+        lv2_log_note(&logger, "SignalViewUI fftSize:%d\n", fftSize);
+        send_ui_state();
+    }else if(e->key == ',' || e->key == '.'){
+        overlap = FFT::ValidateOverlap(e->key == '.' ? overlap+1 : overlap-1);
+        if(spectrum) spectrum->SetFFT(fftSize, overlap);
+        lv2_log_note(&logger, "SignalViewUI overlap:%d\n", overlap);
+        send_ui_state();
+    }else if(e->key == 'd'){
+        // toggle the analysis between the plugin and the UI
+        dspAnalysis = !dspAnalysis;
+        lv2_log_note(&logger, "SignalViewUI analysis:%s\n",
+            dspAnalysis ? "dsp" : "ui");
+        send_ui_state();
+    }else if(e->key == 't'){
+        // cycle through the raw audio transport formats
+        transport = (transport + 1) % TRANSPORT_NFORMATS;
+        lv2_log_note(&logger, "SignalViewUI transport:%s\n",
+            Transport::Name((TransportFormat)transport));
+        send_ui_state();
+    }else if(e->key == 'i'){
+        // toggle interpolation of bins sparser than the pixels
+        interpolate = !interpolate;
+        if(spectrum) spectrum->SetInterpolate(interpolate);
+        lv2_log_note(&logger, "SignalViewUI interpolate:%s\n",
+            interpolate ? "on" : "off");
+    }else if(e->key == 'g'){
+        // cycle the trigger through off, auto, normal and single
+        trigger.mode = Trigger::Validate((trigger.mode + 1) % TRIGGER_NMODES);
+        if(spectrum) spectrum->SetTrigger(trigger);
+        lv2_log_note(&logger, "SignalViewUI trigger:%s\n",
+            Trigger::Name(trigger.mode));
+    }else if(e->key == ' '){
+        // rearm a single trigger
+        if(spectrum) spectrum->RearmTrigger();
+    }else if(e->key == 'e'){
+        trigger.edge = trigger.edge==TRIGGER_RISING ? TRIGGER_FALLING : TRIGGER_RISING;
+        if(spectrum) spectrum->SetTrigger(trigger);
+        lv2_log_note(&logger, "SignalViewUI trigger edge:%s\n",
+            Trigger::EdgeName(trigger.edge));
+    }else if(e->key == PUGL_KEY_UP || e->key == PUGL_KEY_DOWN){
+        // move the trigger level in steps of 0.05 of full scale
+        float level = trigger.level + (e->key == PUGL_KEY_UP ? 0.05f : -0.05f);
+        level = roundf(level*20.0f)/20.0f;
+        if(level > 1.0f) level = 1.0f;
+        if(level < -1.0f) level = -1.0f;
+        trigger.level = level;
+        if(spectrum) spectrum->SetTrigger(trigger);
+        lv2_log_note(&logger, "SignalViewUI trigger level:%.2f\n", level);
+    }else if(e->key == '-' || e->key == '='){
+        // step the time view through 1-2-5 lengths
+        trigger.time = Trigger::StepTime(trigger.time, e->key == '=' ? 1 : -1);
+        if(spectrum) spectrum->SetTrigger(trigger);
+        lv2_log_note(&logger, "SignalViewUI trigger time:%gs\n", trigger.time);
+    }else if(e->key == 'h'){
+        // cycle the holdoff through 0, 1, 10 and 100 ms
+        trigger.holdoff = trigger.holdoff >= 0.1 ? 0.0
+            : trigger.holdoff > 0.0 ? trigger.holdoff*10.0 : 0.001;
+        if(spectrum) spectrum->SetTrigger(trigger);
+        lv2_log_note(&logger, "SignalViewUI trigger holdoff:%gs\n", trigger.holdoff);
+    }else if(e->key == 'p'){
+        // hold the waterfall to scroll through its history
+        paused = !paused;
+        if(spectrum) spectrum->SetWaterfallPaused(paused);
+        lv2_log_note(&logger, "SignalViewUI waterfall:%s\n",
+            paused ? "paused" : "running");
+    }else if(e->key == 'y'){
+        // cycle the waterfall history through 10, 30, 60, 120 and 300 s
+        history = history >= 300.0f ? 10.0f
+            : history >= 120.0f ? 300.0f
+            : history >= 60.0f ? 120.0f
+            : history >= 30.0f ? 60.0f : 30.0f;
+        if(spectrum) spectrum->SetWaterfallHistory(history);
+        lv2_log_note(&logger, "SignalViewUI waterfall history:%gs\n", history);
+    }
+}
+
 void SignalViewUI::port_event(
     uint32_t port_index,
     uint32_t buffer_size,
@@ -360,7 +623,15 @@ void SignalViewUI::port_event(
         if(lv2_atom_forge_is_object_type(&forge, atom->type)){
             const LV2_Atom_Object* obj = (const LV2_Atom_Object*)atom;
             if(obj->body.otype == uris->RawAudio){
+                rx_bytes_raw += buffer_size;
                 recv_raw_audio(obj);
+            }else if(obj->body.otype == uris->Spectra){
+                rx_bytes_spectra += buffer_size;
+                // the RawAudio count resumes past the spectra
+                rx_sync = false;
+                recv_spectra(obj);
+            }else if(obj->body.otype == uris->ShmRing){
+                recv_shm_ring(obj);
             }else if(obj->body.otype == uris->ui_State){
                 recv_ui_state(obj);
             }
@@ -412,10 +683,7 @@ PuglStatus SignalViewUI::onEvent(PuglView* view, const PuglEvent* event)
         break;
     case PUGL_KEY_PRESS:
         //printf("PUGL_KEY_PRESS\n");
-        if (event->key.key == 'q' || event->key.key == PUGL_KEY_ESCAPE)
-        {
-            quit = true;
-        }
+        onKeyPress(&event->key);
         break;
     case PUGL_SCROLL:
         onScroll(event->scroll.y, event->scroll.dy);
@@ -487,6 +755,21 @@ void SignalViewUI::send_ui_state(void)
     lv2_atom_forge_key(&forge, uris->ui_log);
     lv2_atom_forge_bool(&forge, log);
 
+    lv2_atom_forge_key(&forge, uris->ui_window);
+    lv2_atom_forge_int(&forge, window);
+
+    lv2_atom_forge_key(&forge, uris->ui_fftSize);
+    lv2_atom_forge_int(&forge, fftSize);
+
+    lv2_atom_forge_key(&forge, uris->ui_overlap);
+    lv2_atom_forge_int(&forge, overlap);
+
+    lv2_atom_forge_key(&forge, uris->ui_dspAnalysis);
+    lv2_atom_forge_bool(&forge, dspAnalysis);
+
+    lv2_atom_forge_key(&forge, uris->ui_transport);
+    lv2_atom_forge_int(&forge, transport);
+
     lv2_atom_forge_pop(&forge, &frame);
 
     write(
@@ -535,6 +818,28 @@ void SignalViewUI::send_ui_enable(void)
   
 }
 
+void SignalViewUI::send_ui_shm_ack(void)
+{
+    lv2_atom_forge_set_buffer(&forge, obj_buf, sizeof(obj_buf));
+
+    LV2_Atom_Forge_Frame frame;
+    LV2_Atom*            msg =
+      (LV2_Atom*)lv2_atom_forge_object(&forge, &frame, 0, uris->ui_ShmAck);
+  
+    assert(msg);
+  
+    const char* name = shm_ring->GetName();
+    lv2_atom_forge_key(&forge, uris->shmName);
+    lv2_atom_forge_string(&forge, name, strlen(name));
+
+    lv2_atom_forge_pop(&forge, &frame);
+    write(controller,
+              0,
+              lv2_atom_total_size(msg),
+              uris->atom_eventTransfer,
+              msg);
+}
+
 void SignalViewUI::send_ui_send_state(void)
 {
     lv2_atom_forge_set_buffer(&forge, obj_buf, sizeof(obj_buf));
@@ -556,44 +861,153 @@ void SignalViewUI::send_ui_send_state(void)
 void SignalViewUI::recv_raw_audio(const LV2_Atom_Object* obj)
 {
     const LV2_Atom* nChannels_atom = NULL;
+    const LV2_Atom* count_atom = NULL;
+    const LV2_Atom* format_atom = NULL;
+    const LV2_Atom* exponent_atom = NULL;
     const LV2_Atom* data_atom = NULL;
-    const int n_props = lv2_atom_object_get(
+    lv2_atom_object_get(
         obj,
         uris->nChannels, &nChannels_atom,
+        uris->sampleCount, &count_atom,
+        uris->audioFormat, &format_atom,
+        uris->blockExponent, &exponent_atom,
         uris->audioData, &data_atom,
         0);
     
-    if(n_props!=2 || nChannels_atom->type!=uris->atom_Int
-    || data_atom->type!=uris->atom_Vector){
+    if(!nChannels_atom || !count_atom || !format_atom || !data_atom
+    || nChannels_atom->type!=uris->atom_Int
+    || count_atom->type!=uris->atom_Long
+    || format_atom->type!=uris->atom_Int){
         return;
     }
-    const int nChannels = ((const LV2_Atom_Int*)nChannels_atom)->body;
-    if(nChannels!=2){
+    if(((const LV2_Atom_Int*)nChannels_atom)->body!=nChannels){
         return;
     }
-    const LV2_Atom_Vector* vec = (const LV2_Atom_Vector*)data_atom;
-    if(vec->body.child_type != uris->atom_Float){
+    // the data must lie inside the object before it is decoded
+    const uint8_t* obj_end = (const uint8_t*)&obj->body + obj->atom.size;
+    const uint8_t* data_body = (const uint8_t*)(data_atom+1);
+    if(data_body > obj_end || data_atom->size > (size_t)(obj_end - data_body)){
         return;
     }
-    const size_t n_elem =
-        (data_atom->size - sizeof(LV2_Atom_Vector_Body))/sizeof(float)/nChannels;
+    const int format = ((const LV2_Atom_Int*)format_atom)->body;
+    const float* data;
+    size_t n_elem;
+    if(format==TRANSPORT_FLOAT32){
+        if(data_atom->type!=uris->atom_Vector){
+            return;
+        }
+        const LV2_Atom_Vector* vec = (const LV2_Atom_Vector*)data_atom;
+        if(data_atom->size < sizeof(LV2_Atom_Vector_Body)
+        || vec->body.child_type != uris->atom_Float){
+            return;
+        }
+        n_elem =
+            (data_atom->size - sizeof(LV2_Atom_Vector_Body))/sizeof(float)/nChannels;
+        data = (const float*)(&vec->body+1);
+    }else if(format==TRANSPORT_FLOAT16 || format==TRANSPORT_INT16){
+        if(data_atom->type!=uris->atom_Chunk){
+            return;
+        }
+        n_elem = data_atom->size/sizeof(uint16_t)/nChannels;
+        if(n_elem > RAW_CHUNK_FRAMES){
+            return;
+        }
+        int exponent = 0;
+        if(format==TRANSPORT_INT16){
+            if(!exponent_atom || exponent_atom->type!=uris->atom_Int){
+                return;
+            }
+            exponent = ((const LV2_Atom_Int*)exponent_atom)->body;
+        }
+        Transport::Decode((TransportFormat)format,
+            (const uint16_t*)(data_atom+1), n_elem*nChannels, exponent,
+            rx_buffer.get());
+        data = rx_buffer.get();
+    }else{
+        return;
+    }
+
+    // a count past the expected one is a gap, a count before it means
+    // the plugin restarted
+    const int64_t count = ((const LV2_Atom_Long*)count_atom)->body;
+    if(rx_sync && count > rx_sample_next){
+        rx_dropped += count - rx_sample_next;
+    }
+    rx_sample_next = count + (int64_t)n_elem;
+    rx_sync = true;
 
-    const float* data = (const float*)(&vec->body+1);
     if(spectrum){
-        for(size_t i=0;i<n_elem;i++){
-            float l = *(data++);
-            float r = *(data++);
-            spectrum->EvaluateSample(l, r);
-        }
+        spectrum->EvaluateBlock(data, n_elem);
+    }
+}
+
+void SignalViewUI::recv_spectra(const LV2_Atom_Object* obj)
+{
+    const LV2_Atom* nChannels_atom = NULL;
+    const LV2_Atom* nPoints_atom = NULL;
+    const LV2_Atom* spectra_atom = NULL;
+    const LV2_Atom* envelope_atom = NULL;
+    const int n_props = lv2_atom_object_get(
+        obj,
+        uris->nChannels, &nChannels_atom,
+        uris->nPoints, &nPoints_atom,
+        uris->spectraData, &spectra_atom,
+        uris->envelopeData, &envelope_atom,
+        0);
+
+    if(n_props!=4 || nChannels_atom->type!=uris->atom_Int
+    || nPoints_atom->type!=uris->atom_Int
+    || spectra_atom->type!=uris->atom_Chunk
+    || envelope_atom->type!=uris->atom_Vector){
+        return;
+    }
+    const int nPoints = ((const LV2_Atom_Int*)nPoints_atom)->body;
+    if(((const LV2_Atom_Int*)nChannels_atom)->body!=nChannels || nPoints<2
+    || spectra_atom->size!=nPoints*nChannels*sizeof(uint16_t)){
+        return;
+    }
+    const LV2_Atom_Vector* vec = (const LV2_Atom_Vector*)envelope_atom;
+    if(vec->body.child_type != uris->atom_Float
+    || envelope_atom->size - sizeof(LV2_Atom_Vector_Body)
+        != SPECTRA_ENVELOPE_POINTS*2*nChannels*sizeof(float)){
+        return;
+    }
+
+    const uint16_t* spectra = (const uint16_t*)(spectra_atom+1);
+    const float* envelope = (const float*)(&vec->body+1);
+    if(spectrum){
+        spectrum->InsertSpectra(spectra, nPoints);
+        spectrum->InsertEnvelope(envelope, SPECTRA_ENVELOPE_POINTS);
     }
 }
 
+void SignalViewUI::recv_shm_ring(const LV2_Atom_Object* obj)
+{
+    const LV2_Atom* name_atom = NULL;
+    lv2_atom_object_get(obj, uris->shmName, &name_atom, 0);
+    if(!name_atom || name_atom->type!=uris->atom_String
+    || name_atom->size<2 || name_atom->size>SHM_NAME_LENGTH){
+        return;
+    }
+    // mapped by the UI thread in onExpose
+    shm_sem.wait();
+    memcpy(shm_pending_name, name_atom+1, name_atom->size);
+    shm_pending_name[SHM_NAME_LENGTH-1] = 0;
+    shm_pending = true;
+    shm_sem.post();
+}
+
 void SignalViewUI::recv_ui_state(const LV2_Atom_Object* obj)
 {
     const LV2_Atom* dB_min_atom = NULL;
     const LV2_Atom* dB_max_atom = NULL;
     const LV2_Atom* linFreq_atom = NULL;
     const LV2_Atom* log_atom = NULL;
+    const LV2_Atom* window_atom = NULL;
+    const LV2_Atom* fftSize_atom = NULL;
+    const LV2_Atom* overlap_atom = NULL;
+    const LV2_Atom* dspAnalysis_atom = NULL;
+    const LV2_Atom* transport_atom = NULL;
     const LV2_Atom* rate_atom = NULL;
     lv2_atom_object_get(
         obj,
@@ -601,6 +1015,11 @@ void SignalViewUI::recv_ui_state(const LV2_Atom_Object* obj)
         uris->ui_dB_max, &dB_max_atom,
         uris->ui_linFreq, &linFreq_atom,
         uris->ui_log, &log_atom,
+        uris->ui_window, &window_atom,
+        uris->ui_fftSize, &fftSize_atom,
+        uris->ui_overlap, &overlap_atom,
+        uris->ui_dspAnalysis, &dspAnalysis_atom,
+        uris->ui_transport, &transport_atom,
         uris->param_sampleRate, &rate_atom,
         0);
     if(dB_min_atom) {
@@ -615,6 +1034,21 @@ void SignalViewUI::recv_ui_state(const LV2_Atom_Object* obj)
     if(log_atom) {
         log = ((const LV2_Atom_Bool*)log_atom)->body != 0;
     }
+    if(window_atom) {
+        window = FFTWindow::Validate(((const LV2_Atom_Int*)window_atom)->body);
+    }
+    if(fftSize_atom) {
+        fftSize = FFT::ValidateSize(((const LV2_Atom_Int*)fftSize_atom)->body);
+    }
+    if(overlap_atom) {
+        overlap = FFT::ValidateOverlap(((const LV2_Atom_Int*)overlap_atom)->body);
+    }
+    if(dspAnalysis_atom) {
+        dspAnalysis = ((const LV2_Atom_Bool*)dspAnalysis_atom)->body != 0;
+    }
+    if(transport_atom) {
+        transport = Transport::Validate(((const LV2_Atom_Int*)transport_atom)->body);
+    }
     if(rate_atom) {
         rate = ((const LV2_Atom_Float*)rate_atom)->body;
 
@@ -627,7 +1061,7 @@ void SignalViewUI::recv_ui_state(const LV2_Atom_Object* obj)
 static LV2UI_Handle instantiate(const struct LV2UI_Descriptor *descriptor, const char *plugin_uri, const char *bundle_path, LV2UI_Write_Function write_function, LV2UI_Controller controller, LV2UI_Widget *widget, const LV2_Feature *const *features)
 {
     //printf("instantiate\n");
-    if (strcmp (plugin_uri, SIGNAL_VIEW_URI) != 0) return nullptr;
+    if (signal_view_channels(plugin_uri) == 0) return nullptr;
 
     SignalViewUI* ui;
     try
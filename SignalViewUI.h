@@ -20,6 +20,8 @@
 #include "uris.h"
 #include "Spectrum.h"
 #include "Semaphore.h"
+#include "Transport.h"
+#include "ShmRing.h"
 
 #include <lv2/atom/atom.h>
 #include <lv2/atom/forge.h>
@@ -32,6 +34,7 @@
 #include <lv2/log/logger.h>
 
 #include <assert.h>
+#include <math.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -41,6 +44,7 @@
 #include <system_error>
 #include <functional>
 #include <chrono>
+#include <atomic>
 
 #define GLAD_GL_IMPLEMENTATION
 #include "glad/gl.h"
@@ -73,15 +77,48 @@ class SignalViewUI
     bool  state_valid;
     bool  view_ready;
     bool  quit;
+    int   nChannels; // of the plugin variant
     float rate;
     float dB_min;
     float dB_max;
     float linFreq;
     bool  log;
+    int   window;
+    int   fftSize;
+    int   overlap;
+    bool  dspAnalysis;
+    int   transport;
+    bool  interpolate;
+    TriggerSettings trigger;
+    // waterfall history in seconds, and whether it is held
+    float history;
+    bool  paused;
 
     PuglWorld* world;
     PuglView*  view;
     std::chrono::time_point<std::chrono::steady_clock> time_last;
+    std::chrono::time_point<std::chrono::steady_clock> stats_time_last;
+    uint64_t   stats_produced_last;
+    uint64_t   stats_consumed_last;
+    uint64_t   stats_graph_ns_last;
+    uint64_t   stats_graph_frames_last;
+    std::atomic<uint64_t> rx_bytes_raw;
+    std::atomic<uint64_t> rx_bytes_spectra;
+    uint64_t   stats_rx_raw_last;
+    uint64_t   stats_rx_spectra_last;
+    // gap detection on the RawAudio sample count
+    bool       rx_sync;
+    int64_t    rx_sample_next;
+    std::atomic<uint64_t> rx_dropped;
+    std::unique_ptr<float[]> rx_buffer; // decoded 16 bit RawAudio
+
+    // shared memory ring offered by the plugin, mapped on the UI thread
+    Semaphore  shm_sem;
+    bool       shm_pending;
+    char       shm_pending_name[SHM_NAME_LENGTH];
+    std::unique_ptr<ShmRing> shm_ring;
+    uint64_t   shm_read;
+    uint64_t   stats_dropped_last;
     float      frame_rate;
     double     timeout;
     int        width;
@@ -111,16 +148,23 @@ class SignalViewUI
     void teardownGL(void);
     void onConfigure(int width, int height);
     void onExpose(void);
+    void logStats(void);
     void onScroll(int y, int dy);
     void onButtonPress(const PuglButtonEvent* e);
     void onButtonRelease(const PuglButtonEvent* e);
     void onMotion(const PuglMotionEvent* e);
+    void onKeyPress(const PuglKeyEvent* e);
 
     void send_ui_state(void);
     void send_ui_disable(void);
     void send_ui_enable(void);
     void send_ui_send_state(void);
     void recv_raw_audio(const LV2_Atom_Object* obj);
+    void recv_spectra(const LV2_Atom_Object* obj);
+    void recv_shm_ring(const LV2_Atom_Object* obj);
+    void send_ui_shm_ack(void);
+    void mapShmRing(void);
+    void readShmRing(void);
     void recv_ui_state(const LV2_Atom_Object* obj);
 
     public:
@@ -0,0 +1,55 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  ==============================================================================
+
+    SignalViewWisdom.cpp
+
+    Measures the fftw plans of one FFT shape into the wisdom cache. The
+    plugin and the UI start it on a cache miss so that the measurement
+    does not hold up their own planning; it can also be run by hand to
+    fill the cache ahead of time:
+
+        SignalViewWisdom f|d Nfft Nchannels pairs
+
+  ==============================================================================
+*/
+
+#include "FFT.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int main(int argc, char **argv)
+{
+    if(argc!=5 || (strcmp(argv[1], "f")!=0 && strcmp(argv[1], "d")!=0)){
+        fprintf(stderr, "usage: %s f|d Nfft Nchannels pairs\n", argv[0]);
+        return 2;
+    }
+    FFTPrecision precision = argv[1][0]=='f' ? FFT_FLOAT : FFT_DOUBLE;
+    int Nfft = FFT::ValidateSize(atoi(argv[2]));
+    int Nchannels = atoi(argv[3]);
+    bool pairs = atoi(argv[4])!=0;
+    if(Nchannels < 1){
+        fprintf(stderr, "%s: Nchannels must be at least 1\n", argv[0]);
+        return 2;
+    }
+    return FFT::Measure(Nfft, Nchannels, precision, pairs) ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  ==============================================================================
+
+    SpectraFormat.h
+
+    Wire format of the 'Spectra' object sent by the plugin when the
+    analysis runs on the DSP side.
+
+    spectraData  atom:Chunk of uint16, nPoints values per channel,
+                 channel-major. A value q is
+                 (q/SPECTRA_DB_SCALE + SPECTRA_DB_FLOOR) dB.
+    envelopeData atom:Vector of float, SPECTRA_ENVELOPE_POINTS (min,max)
+                 pairs per channel, channel-major, covering the last
+                 Nfft samples.
+
+    When the spectrum has more bins than fit in a message it is peak
+    decimated by a power of two: value 0 is bin 0 and value j>0 is the
+    maximum of bins (j-1)*D+1 .. j*D.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#define SPECTRA_DB_FLOOR        -200.0f
+#define SPECTRA_DB_SCALE        100.0f
+#define SPECTRA_POINTS_MAX      1025
+#define SPECTRA_ENVELOPE_POINTS 256
+// rate the DSP side sends spectra at, the UI update rate in the ttl
+#define SPECTRA_RATE            60.0f
+
+static inline uint16_t spectra_quantize(float dB)
+{
+    float q = (dB - SPECTRA_DB_FLOOR)*SPECTRA_DB_SCALE + 0.5f;
+    if(q < 0.0f) return 0;
+    if(q > 65535.0f) return 65535;
+    return (uint16_t)q;
+}
+
+static inline float spectra_dequantize(uint16_t q)
+{
+    return q*(1.0f/SPECTRA_DB_SCALE) + SPECTRA_DB_FLOOR;
+}
+
+// bin k of a spectrum decimated by D
+static inline int spectra_decimated_index(int k, int D)
+{
+    return k==0 ? 0 : (k-1)/D + 1;
+}
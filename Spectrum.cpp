@@ -29,101 +29,353 @@
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include "Spectrum.h"
+#include "Decibel.h"
 #include <cmath>
 #include <cstring>
 #include <iostream>
-#include <new>
+#include <stdexcept>
 #include <glm/gtx/color_space.hpp>
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 Spectrum::Spectrum(
     int Nfft,
+    int nChannels,
     double fsamplerate,
     float frame_rate,
     int Ncopy,
-    const char* bundle_path)
+    const char* bundle_path,
+    FFTPrecision precision)
     :
     Nfft(Nfft),
+    nChannels(nChannels),
+    Ncopy(Ncopy),
+    bundle_path(bundle_path),
     fsamplerate(fsamplerate),
     frame_rate(frame_rate),
-    Ncopy(Ncopy),
-    bundle_path(bundle_path)
+    precision(precision)
+{
+    time_color0.reset(new glm::vec4[nChannels]);
+    time_color1.reset(new glm::vec4[nChannels]);
+    freq_color0.reset(new glm::vec4[nChannels]);
+    freq_color1.reset(new glm::vec4[nChannels]);
+    fill_color.reset(new glm::vec4[nChannels]);
+    line_offset.reset(new GLintptr[nChannels]);
+    SetColors(30.0f);
+    log = false;
+    log_last = false;
+    alpha_width = 1.0f;
+    interpolate = true;
+    map_width = 0;
+    map_valid = false;
+    dB_min = -180.0f;
+    dB_max = 0.0f;
+    window_type = WINDOW_DEFAULT;
+    stereo_mode = STEREO_PACKED;
+    config_pending = false;
+    waterfall_history = WATERFALL_HISTORY_DEFAULT;
+    waterfall_paused = false;
+    waterfall_paused_last = false;
+    history_pending = false;
+    frames_produced = 0;
+    frames_consumed = 0;
+    dropped = 0;
+    graph_time = std::chrono::steady_clock::duration::zero();
+    graph_frames = 0;
+    trigger.reset(new Trigger(nChannels, fsamplerate));
+    x_trigger_size = 0;
+    N_trigger = 0;
+    trigger_count = trigger->GetCaptureCount();
+    // plans missing from the wisdom cache are measured by the bundle's tool
+    FFT::SetWisdomTool(bundle_path);
+
+    Allocate();
+    StartAnalysis();
+}
+    
+Spectrum::~Spectrum()
+{
+    StopAnalysis();
+}
+
+void Spectrum::Allocate(void)
 {
     Npoints = Nfft/2 + 1;
-    Nfft_draw = (Nfft-1)*2 + 1;
-    Ndx_draw = Nfft - 1;
-    x_fft.reset(new double[Nfft]);
-    X_fft.reset(new std::complex<double>[Npoints]);
-    X_db_l.reset(new float[Npoints]);
-    X_db_r.reset(new float[Npoints]);
+    Ntime_draw = (TIME_SHADE_MAX-1)*2 + 1;
+    Ndx_draw = TIME_SHADE_MAX - 1;
+    for(int w=0;w<WINDOW_NTYPES;w++){
+        windows[w].reset(nullptr);
+    }
+    fft.reset(nullptr);
+    fft.reset(new FFT(Nfft, nChannels, precision));
+    X_pow.reset(new float[Npoints*nChannels]);
+    X_db.reset(new float[Npoints*nChannels]);
     x_points.reset(new float[Npoints]);
-    X_db_l_p.reset(new float[Npoints]);
-    X_db_r_p.reset(new float[Npoints]);
-    x_points_p.reset(new float[Npoints]);
-    x_plan = fftw_plan_dft_r2c_1d(
-        Nfft,
-        x_fft.get(),
-        reinterpret_cast<fftw_complex*>(X_fft.get()),
-        FFTW_MEASURE);
+    // a point per pixel column at most, and never more than the bins
+    // unless they are interpolated
+    Npoints_p_max = (Npoints > SPECTRUM_PIXELS_MAX + 2) ? Npoints : SPECTRUM_PIXELS_MAX + 2;
+    X_db_p.reset(new float[Npoints_p_max*nChannels]);
+    x_points_p.reset(new float[Npoints_p_max]);
+    point_map.reset(new PointSpan[Npoints_p_max]);
+    map_valid = false;
     dataReady = false;
-    x_cyclic_in_l.reset(new float[Nfft]);
-    x_cyclic_in_r.reset(new float[Nfft]);
-    x_draw_l_raw.reset(new std::unique_ptr<float[]>[2]);
-    x_draw_r_raw.reset(new std::unique_ptr<float[]>[2]);
-    x_draw_l_raw[0].reset(new float[Nfft]);
-    x_draw_l_raw[1].reset(new float[Nfft]);
-    x_draw_r_raw[0].reset(new float[Nfft]);
-    x_draw_r_raw[1].reset(new float[Nfft]);
+    x_cyclic_in.reset(new float[Nfft*nChannels]);
+    x_draw_raw.reset(new std::unique_ptr<float[]>[2]);
+    x_draw_raw[0].reset(new float[Nfft*nChannels]);
+    x_draw_raw[1].reset(new float[Nfft*nChannels]);
     dx_draw_raw.reset(new float[Ndx_draw]);
-    x_draw.reset(new float[Nfft_draw]);
-    v_draw.reset(new float[Nfft_draw]);
-    x_in_l.reset(new std::unique_ptr<float[]>[Ncopy]);
-    x_in_r.reset(new std::unique_ptr<float[]>[Ncopy]);
-    for(int c=0;c<Ncopy;c++){
-        x_in_l[c].reset(new float[Nfft]);
-        x_in_r[c].reset(new float[Nfft]);
-    }
-    SetColors(30.0f);
-    index_last=0;
+    x_draw.reset(new float[Ntime_draw]);
+    v_draw.reset(new float[Ntime_draw]);
+    band_min.reset(new float[SPECTRUM_PIXELS_MAX]);
+    band_max.reset(new float[SPECTRUM_PIXELS_MAX]);
+
+    // The capture fifo must hold every hop of a large host block. One
+    // buffer more than the fifo depth is allocated for the frame being
+    // analysed.
+    Ncount = Nfft/Ncopy;
+    Nframes_fifo = Ncopy;
+    if(Nframes_fifo < MAX_BLOCK_FRAMES/Ncount)
+        Nframes_fifo = MAX_BLOCK_FRAMES/Ncount;
+    Nframe = Nfft*nChannels;
+    x_in.reset(new float[(size_t)Nframe*(Nframes_fifo+1)]);
+
+    // A backlog of frames is transformed Nbatch at a time by one plan.
+    // The batch is kept to BATCH_SAMPLES_MAX so that large FFTs don't
+    // multiply the memory of the plan.
+    Nbatch = BATCH_SAMPLES_MAX/Nframe;
+    if(Nbatch > BATCH_FRAMES_MAX) Nbatch = BATCH_FRAMES_MAX;
+    if(Nbatch > Nframes_fifo) Nbatch = Nframes_fifo;
+    batch_fft.reset(nullptr);
+    if(Nbatch > 1)
+        batch_fft.reset(new FFT(Nfft, nChannels*Nbatch, precision, false));
     i_buffer = 0;
     i_sample = 0;
-    Ncount = Nfft/Ncopy;
     count = Ncount;
     i_draw_front = 0;
     i_draw_back = 1;
-    log = false;
-    log_last = false;
-    for(int i=0;i<Nfft;i++){
-        x_draw_l_raw[i_draw_front][i] = 0.0f;
-        x_draw_r_raw[i_draw_front][i] = 0.0f;
+    memset(x_cyclic_in.get(), 0, sizeof(float)*Nfft*nChannels);
+    memset(x_draw_raw[i_draw_front].get(), 0, sizeof(float)*Nfft*nChannels);
+    for(int i=0;i<Npoints*nChannels;i++){
+        X_db[i] = -180.0f;
     }
+
+    // The line fifo holds the spectra waiting for the render thread.
+    // It is sized for a few frames worth of lines. One extra buffer is
+    // allocated for the line being drawn so the worker never
+    // overwrites it.
+    float line_rate = fsamplerate/Ncount;
+    Nlines_fifo = Ncopy*4;
+    int lines_per_frame = (int)ceilf(line_rate/frame_rate);
+    if(Nlines_fifo < lines_per_frame*4)
+        Nlines_fifo = lines_per_frame*4;
+    Nline = Npoints*nChannels;
+    X_db_lines.reset(new float[(size_t)Nline*(Nlines_fifo+1)]);
+    line_ptrs.reset(new const float*[Nlines_fifo]);
+    i_line_buffer = 0;
+
+    sample_count = 0;
+    frame_sequence = 0;
+    frameFifo.reset(new SpscRing<FrameDesc>(Nframes_fifo));
+    lineFifo.reset(new SpscRing<FrameDesc>(Nlines_fifo));
 }
-    
-Spectrum::~Spectrum()
+
+void Spectrum::StartAnalysis(void)
+{
+    analysis_quit = false;
+    analysis_thread = std::thread(&Spectrum::AnalysisLoop, this);
+}
+
+void Spectrum::StopAnalysis(void)
+{
+    if(!analysis_thread.joinable())
+        return;
+    analysis_quit = true;
+    analysis_sem.post();
+    analysis_thread.join();
+}
+
+void Spectrum::SetFFT(int Nfft, int Ncopy)
+{
+    Nfft = FFT::ValidateSize(Nfft);
+    Ncopy = FFT::ValidateOverlap(Ncopy);
+    if(Nfft==Spectrum::Nfft && Ncopy==Spectrum::Ncopy)
+        return;
+    Nfft_pending = Nfft;
+    Ncopy_pending = Ncopy;
+    config_pending = true;
+}
+
+/*
+    Apply a new FFT size and overlap. Runs on the render thread with the
+    GL context current; the GL objects are rebuilt in place. If the new
+    size cannot be allocated or planned the previous one is restored.
+*/
+void Spectrum::Reconfigure(void)
+{
+    std::lock_guard<std::mutex> lock(config_mutex);
+    StopAnalysis();
+    int Nfft_last = Nfft;
+    int Ncopy_last = Ncopy;
+    Nfft = Nfft_pending;
+    Ncopy = Ncopy_pending;
+    try {
+        Allocate();
+    }
+    catch(const std::exception& e) {
+        std::cout << "Spectrum::Reconfigure failed for Nfft="
+            << Nfft << ": " << e.what() << std::endl;
+        Nfft = Nfft_last;
+        Ncopy = Ncopy_last;
+        Allocate();
+    }
+    GLDestroy();
+    GLInit();
+    StartAnalysis();
+}
+
+void Spectrum::AnalysisLoop(void)
+{
+    while(true){
+        analysis_sem.wait();
+        if(analysis_quit)
+            break;
+        // The frames are only released after they are analysed, the
+        // producer can't overwrite a buffer in use.
+        while(frameFifo->Peek(0, batch[0])){
+            // gather a run of captured frames in consecutive buffers
+            int n = 1;
+            if(batch_fft && !(batch[0].flags & FRAME_SPECTRA)){
+                while(n<Nbatch
+                    && frameFifo->Peek(n, batch[n])
+                    && !(batch[n].flags & FRAME_SPECTRA)
+                    && batch[n].index==batch[0].index + n){
+                    n++;
+                }
+            }
+            size_t lines_free = Nlines_fifo - lineFifo->GetNumReady();
+            if(n==Nbatch && lines_free>=(size_t)n){
+                AnalyseBatch(n);
+                frameFifo->Advance(n);
+            }else{
+                AnalyseFrame(batch[0]);
+                frameFifo->Advance(1);
+            }
+        }
+    }
+}
+
+void Spectrum::AnalyseFrame(const FrameDesc &frame)
+{
+    if(lineFifo->GetNumReady()>=(size_t)Nlines_fifo){
+        // the render thread has fallen behind, drop the frame
+        return;
+    }
+    if(frame.flags & FRAME_SPECTRA){
+        memcpy(&X_db_lines[(size_t)i_line_buffer*Nline],
+            &x_in[(size_t)frame.index*Nframe], sizeof(float)*Nline);
+    }else{
+        ComputeSpectra(
+            &x_in[(size_t)frame.index*Nframe],
+            &X_db_lines[(size_t)i_line_buffer*Nline]);
+    }
+    FrameDesc line = frame;
+    line.index = i_line_buffer;
+    lineFifo->Push(line);
+    i_line_buffer++;
+    if(i_line_buffer>Nlines_fifo)
+        i_line_buffer = 0;
+    frames_produced++;
+}
+
+/*
+    Analyse the n frames in batch[], which are in consecutive capture
+    buffers, with one execution of the batch plan and one dB pass
+    straight into the line buffers.
+*/
+void Spectrum::AnalyseBatch(int n)
 {
+    FFTWindow *window = GetWindow();
+    batch_fft->Execute(window, &x_in[(size_t)batch[0].index*Nframe]);
+
+    // the line buffers may wrap within the batch
+    float norm2 = PowerNorm(window);
+    int n1 = Nlines_fifo + 1 - i_line_buffer;
+    if(n1 > n) n1 = n;
+    batch_fft->DecibelSpectrum(&X_db_lines[(size_t)i_line_buffer*Nline], norm2,
+                               0, n1*nChannels);
+    if(n1 < n)
+        batch_fft->DecibelSpectrum(&X_db_lines[0], norm2,
+                                   n1*nChannels, (n - n1)*nChannels);
+
+    for(int k=0;k<n;k++){
+        FrameDesc line = batch[k];
+        line.index = i_line_buffer;
+        lineFifo->Push(line);
+        i_line_buffer++;
+        if(i_line_buffer>Nlines_fifo)
+            i_line_buffer = 0;
+    }
+    frames_produced += n;
+}
+
+void Spectrum::GetAnalysisCounts(uint64_t &produced, uint64_t &consumed)
+{
+    produced = frames_produced;
+    consumed = frames_consumed;
+}
 
+bool Spectrum::GetWisdomHit(void)
+{
+    return fft && fft->GetWisdomHit();
 }
 
 void Spectrum::GLInit(void)
 {
-    tgraph.reset(new TGraph(Nfft_draw));
+    // the most the graphs write in a frame, per channel the y and
+    // shading of the time trace or two band passes, and the spectrum
+    // line the fill shares, with room for the alignment of each
+    size_t time_floats = 2*(size_t)Ntime_draw;
+    if(time_floats < 8*(size_t)SPECTRUM_PIXELS_MAX)
+        time_floats = 8*(size_t)SPECTRUM_PIXELS_MAX;
+    size_t frame_bytes = nChannels*(sizeof(float)*(time_floats + (size_t)Npoints_p_max)
+                                    + 3*STREAM_BUFFER_ALIGN);
+    stream.reset(new StreamBuffer(frame_bytes));
+
+    tgraph.reset(new TGraph(Ntime_draw, stream.get()));
+    Ntime_x = Ntime_draw;
     tgraph->SetLineWidths(3.0f, 1.0f);
     tgraph->SetLimits(1.0f, -1.0f);
     
-    lgraph.reset(new LGraph(Npoints));
+    lgraph.reset(new LGraph(Npoints_p_max, stream.get()));
     lgraph->SetLineWidths( 3.0f, 1.0f );
     lgraph->SetLimits(0.0f, -180.0f);
     
-    fill.reset(new GraphFill(Npoints));
+    fill.reset(new GraphFill());
     fill->SetLimits(0.0f, -180.0f);
 
-    float line_rate = fsamplerate/Nfft*Ncopy;
-    waterfall.reset(new Waterfall(Npoints, 128, line_rate, frame_rate));
+    CreateWaterfall();
 
     grid.reset(new Grid(Nfft, fsamplerate, bundle_path));
 
+    SetdBLimits(dB_min, dB_max);
+    SetWidth(alpha_width*(fsamplerate/2.0));
+    SetDropped(dropped);
     InitializeFrequency();
 }
 
+void Spectrum::CreateWaterfall(void)
+{
+    float line_rate = fsamplerate/Ncount;
+    waterfall.reset(nullptr);
+    waterfall.reset(new Waterfall(Npoints, nChannels, 128, waterfall_history,
+                                  line_rate, frame_rate));
+    waterfall_paused_last = waterfall_paused;
+    waterfall->SetPaused(waterfall_paused_last);
+}
+
 void Spectrum::GLDestroy(void)
 {
     lgraph.reset(nullptr);
@@ -131,107 +383,184 @@ void Spectrum::GLDestroy(void)
     fill.reset(nullptr);
     waterfall.reset(nullptr);
     grid.reset(nullptr);
+    stream.reset(nullptr);
 }
 
-double window_func(double alpha)
+FFTWindow* Spectrum::GetWindow(void)
 {
-    if(alpha>0.5)
-        return 0.0;
-    if(alpha<-0.5)
-        return 0.0;
-    return 0.53836 + 0.46164*cos(2.0*M_PI*(alpha-0.5));
+    // the table for each type is built once on first use
+    int type = window_type;
+    if(!windows[type]){
+        windows[type].reset(new FFTWindow((WindowType)type, Nfft));
+    }
+    return windows[type].get();
 }
 
-double Blackman_Harris_window_func(double alpha)
+// scale from |X|^2 to the power of a full scale sine
+float Spectrum::PowerNorm(FFTWindow *window)
 {
-    double a0 = 0.35875;
-    double a1 = 0.48829;
-    double a2 = 0.14128;
-    double a3 = 0.01168;
-    return a0 - a1*cos(2*M_PI*alpha) + a2*cos(4*M_PI*alpha)
-           - a3*cos(6*M_PI*alpha);
+    float norm_fact = 2.0f/window->GetCoherentGain()/Nfft;
+    return norm_fact*norm_fact;
 }
 
-void Spectrum::ComputeSpectrum(float *x, std::unique_ptr<float[]> &X_db)
+void Spectrum::PowerTodB(const float *X_pow, float *X_db, float norm2)
 {
-    for(int i=0;i<Nfft;i++){
-        double alpha = (double)i/Nfft;
-        x_fft[i] = x[i]*Blackman_Harris_window_func(alpha);
-    }
-    fftw_execute( x_plan );
-    float norm_fact = 2.0f/0.3587500f/Nfft;
-    for(int i=0;i<Npoints;i++){
-        float abs_X = (float)abs(X_fft[i])*norm_fact;
-        //if(i) abs_X*=(float)i*100.0f/Npoints;
-        if(abs_X < 1e-9) abs_X = 1e-9;
-        X_db[i] = 20.0f * log10f(abs_X);
+    Decibel::PowerTodB(X_pow, X_db, (size_t)Nline, norm2);
+}
+
+void Spectrum::ComputeSpectra(const float *x, float *X_db)
+{
+    FFTWindow *window = GetWindow();
+    if(stereo_mode==STEREO_PACKED){
+        fft->ExecutePairs(window, x);
+        fft->PowerSpectrumPairs(X_pow.get());
+        PowerTodB(X_pow.get(), X_db, PowerNorm(window));
+    }else{
+        // the power and dB are formed in one pass over the transform
+        fft->Execute(window, x);
+        fft->DecibelSpectrum(X_db, PowerNorm(window));
     }
 }
 
 void Spectrum::Render(void)
 {
+    if(config_pending.exchange(false)){
+        Reconfigure();
+    }
+    if(history_pending.exchange(false)){
+        CreateWaterfall();
+        waterfall->SetdBLimits(dB_min, dB_max);
+        waterfall->SetViewWidth(alpha_width);
+        // its columns come with the next point map
+        map_valid = false;
+    }
+    const bool paused = waterfall_paused;
+    if(paused!=waterfall_paused_last){
+        waterfall->SetPaused(paused);
+        waterfall_paused_last = paused;
+    }
+
     if(log!=log_last){
         InitializeFrequency();
         log_last = log;
     }
 
-    int n = Ncopy;
-    float *x_l=nullptr;
-    float *x_r=nullptr;
-    while(ptrFifo.GetNumReady()>0 && n!=0){
-        index_last = ptrFifo.Pop();
-        x_l = x_in_l[index_last].get();
-        x_r = x_in_r[index_last].get();
-        ComputeSpectrum(x_l, X_db_l);
-        ComputeSpectrum(x_r, X_db_r);
-        waterfall->InsertLine(X_db_l.get(), X_db_r.get());
-        n--;
+    // upload the lines produced by the analysis worker in one go, they
+    // are released once uploaded
+    size_t n_lines = lineFifo->GetNumReady();
+    if(n_lines > (size_t)Nlines_fifo)
+        n_lines = Nlines_fifo;
+    FrameDesc line;
+    for(size_t l=0;l<n_lines;l++){
+        lineFifo->Peek(l, line);
+        line_ptrs[l] = &X_db_lines[(size_t)line.index*Nline];
+    }
+    if(n_lines>0){
+        waterfall->InsertLines(line_ptrs.get(), (int)n_lines);
+        memcpy(X_db.get(), line_ptrs[n_lines-1], sizeof(float)*Nline);
+        lineFifo->Advance(n_lines);
+        frames_consumed += n_lines;
     }
 
     glEnable(GL_BLEND);
     glBlendFunc(GL_ONE, GL_ONE);
-    
+    stream->BeginFrame();
+    std::chrono::steady_clock::time_point t0;
     
     GLint viewport[4];
     glGetIntegerv(GL_VIEWPORT, viewport);
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
 
+    // the last FFT frame, or the last triggered window
+    const float *x_time = x_draw_raw[i_draw_front].get();
+    int N_time = Nfft;
+    bool triggered;
+    {
+        // the trigger captures on the host thread inside EvaluateBlock
+        std::lock_guard<std::mutex> lock(config_mutex);
+        triggered = trigger->GetMode()!=TRIGGER_OFF;
+        if(triggered && trigger->GetCaptureCount()!=trigger_count){
+            trigger_count = trigger->GetCaptureCount();
+            int N_capture;
+            const float *x_capture = trigger->GetCapture(N_capture);
+            N_trigger = 0;
+            if(x_capture){
+                size_t n = (size_t)N_capture*nChannels;
+                if(n > x_trigger_size){
+                    x_trigger.reset(new float[n]);
+                    x_trigger_size = n;
+                }
+                memcpy(x_trigger.get(), x_capture, sizeof(float)*n);
+                N_trigger = N_capture;
+            }
+        }
+    }
+    if(triggered && N_trigger){
+        x_time = x_trigger.get();
+        N_time = N_trigger;
+    }
+
+    // Zoomed out the samples of a column are drawn as their min/max
+    // band, a couple of vertices per pixel instead of two per sample.
     glViewport(0, 2*viewport[3]/3, viewport[2], viewport[3]/3);
-    tgraph->SetColors(time_color_l0, time_color_l1);
-    ShadeGraph(x_draw_l_raw[i_draw_front], viewport[2], viewport[3]/3);
-    tgraph->SetValue(v_draw.get(), Nfft_draw);
-    tgraph->Draw(x_draw.get(), Nfft_draw);
-
-    tgraph->SetColors(time_color_r0, time_color_r1);
-    ShadeGraph(x_draw_r_raw[i_draw_front], viewport[2], viewport[3]/3);
-    tgraph->SetValue(v_draw.get(), Nfft_draw);
-    tgraph->Draw(x_draw.get(), Nfft_draw);
+    int band_width = viewport[2] < SPECTRUM_PIXELS_MAX ? viewport[2] : SPECTRUM_PIXELS_MAX;
+    bool band = N_time > TIME_BAND_SAMPLES_PER_PIXEL*band_width;
+    if(band && (!time_pyramid || time_pyramid->GetSize()!=N_time))
+        time_pyramid.reset(new MinMaxPyramid(N_time));
+    int N_draw = (N_time-1)*2 + 1;
+    if(!band && N_draw!=Ntime_x){
+        tgraph->SetXLinear(N_draw);
+        Ntime_x = N_draw;
+    }
+    for(int c=0;c<nChannels;c++){
+        tgraph->SetColors(time_color0[c], time_color1[c]);
+        const float *x_raw = &x_time[c*N_time];
+        if(band){
+            time_pyramid->Build(x_raw);
+            time_pyramid->Envelope(0.0, N_time, band_width,
+                band_min.get(), band_max.get());
+            t0 = std::chrono::steady_clock::now();
+            tgraph->DrawBand(band_min.get(), band_max.get(), band_width,
+                viewport[3]/3);
+        }else{
+            ShadeGraph(x_raw, N_time, viewport[2], viewport[3]/3);
+            t0 = std::chrono::steady_clock::now();
+            tgraph->SetValue(v_draw.get(), N_draw);
+            tgraph->Draw(x_draw.get(), N_draw);
+        }
+        graph_time += std::chrono::steady_clock::now() - t0;
+    }
     
     glViewport(0, viewport[3]/3, viewport[2], viewport[3]/3);
     grid->Draw();
     CoalescePoints(viewport[2]);
-    lgraph->SetX(x_points_p.get(), Npoints_p);
-    fill->SetX(x_points_p.get(), Npoints_p);
-    lgraph->SetColors(freq_color_l0, freq_color_l1);
-    lgraph->Draw(X_db_l_p.get(), Npoints_p);
-    lgraph->SetColors(freq_color_r0, freq_color_r1);
-    lgraph->Draw(X_db_r_p.get(), Npoints_p);
-    fill->SetColor(fill_color_l);
-    fill->Draw(X_db_l_p.get(), Npoints_p);
-    fill->SetColor(fill_color_r);
-    fill->Draw(X_db_r_p.get(), Npoints_p);
+    t0 = std::chrono::steady_clock::now();
+    for(int c=0;c<nChannels;c++){
+        lgraph->SetColors(freq_color0[c], freq_color1[c]);
+        line_offset[c] = lgraph->Draw(&X_db_p[c*Npoints_p_max], Npoints_p);
+    }
+    for(int c=0;c<nChannels;c++){
+        fill->SetColor(fill_color[c]);
+        fill->Draw(lgraph->GetXBuffer(), stream->GetBuffer(), line_offset[c],
+                   Npoints_p);
+    }
+    graph_time += std::chrono::steady_clock::now() - t0;
+    graph_frames++;
+    stream->EndFrame();
 
     glDisable(GL_BLEND);
     
     glViewport(0, 0, viewport[2], viewport[3]/3);
-    waterfall->Render(time_color_l1, time_color_r1);
+    waterfall->Render(time_color1.get());
     //std::cout << ".";
     //std::cout.flush();
 }
 
 void Spectrum::SetdBLimits(float dB_min, float dB_max)
 {
+    Spectrum::dB_min = dB_min;
+    Spectrum::dB_max = dB_max;
     if(fill)
         fill->SetLimits(dB_max, dB_min);
     if(lgraph)
@@ -242,9 +571,17 @@ void Spectrum::SetdBLimits(float dB_min, float dB_max)
         grid->SetLimits(dB_max, dB_min);
 }
 
+void Spectrum::SetDropped(uint64_t dropped)
+{
+    Spectrum::dropped = dropped;
+    if(grid)
+        grid->SetDropped(dropped);
+}
+
 void Spectrum::SetWidth(float frequency)
 {
     alpha_width = frequency/(fsamplerate/2.0);
+    map_valid = false;
     if(fill)
         fill->SetViewWidth(alpha_width);
     if(lgraph)
@@ -255,48 +592,160 @@ void Spectrum::SetWidth(float frequency)
         grid->SetViewWidth(alpha_width);
 }
 
-void Spectrum::EvaluateSample(float x_l, float x_r)
+/*
+    Split n interleaved stereo frames into the l and r arrays.
+*/
+static void deinterleave_stereo(const float *src, float *l, float *r, int n)
 {
-    x_cyclic_in_l[i_sample] = x_l;
-    x_cyclic_in_r[i_sample] = x_r;
-    i_sample++;
-    if(i_sample==Nfft)
-    {
-        i_sample = 0;
-        for(int i=0;i<Nfft;i++){
-            x_draw_l_raw[i_draw_back][i] = x_cyclic_in_l[i];
-            x_draw_r_raw[i_draw_back][i] = x_cyclic_in_r[i];
+    int i = 0;
+#if defined(__SSE__)
+    for(;i+4<=n;i+=4){
+        __m128 a = _mm_loadu_ps(src + 2*i);
+        __m128 b = _mm_loadu_ps(src + 2*i + 4);
+        _mm_storeu_ps(l + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0)));
+        _mm_storeu_ps(r + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1)));
+    }
+#elif defined(__ARM_NEON)
+    for(;i+4<=n;i+=4){
+        float32x4x2_t lr = vld2q_f32(src + 2*i);
+        vst1q_f32(l + i, lr.val[0]);
+        vst1q_f32(r + i, lr.val[1]);
+    }
+#endif
+    for(;i<n;i++){
+        l[i] = src[2*i];
+        r[i] = src[2*i+1];
+    }
+}
+
+/*
+    Split n interleaved frames of Nch channels, channel c going to
+    x + c*stride.
+*/
+static void deinterleave(const float *src, int Nch, float *x, int stride, int n)
+{
+    if(Nch==2){
+        deinterleave_stereo(src, x, x + stride, n);
+        return;
+    }
+    for(int c=0;c<Nch;c++){
+        const float *s = src + c;
+        float *d = x + c*stride;
+        for(int i=0;i<n;i++){
+            d[i] = *s;
+            s += Nch;
         }
-        i_draw_front ^= 1;
-        i_draw_back ^= 1;
     }
-    
-    if(--count==0){
-        count = Ncount;
-        if(ptrFifo.GetNumReady()<Ncopy){
-            int N1 = Nfft - i_sample;
-            int N2 = Nfft - N1;
-            int i_src = i_sample;
-            int i_dst = 0;
-            for(int i=0;i<N1;i++){
-                x_in_l[i_buffer][i_dst] = x_cyclic_in_l[i_src];
-                x_in_r[i_buffer][i_dst] = x_cyclic_in_r[i_src];
-                i_src++;
-                i_dst++;
+}
+
+void Spectrum::EvaluateBlock(const float *interleaved, size_t frames)
+{
+    // excludes Reconfigure
+    std::lock_guard<std::mutex> lock(config_mutex);
+    const float *src = interleaved;
+    while(frames>0){
+        // run up to the next cyclic wrap or hop boundary
+        int n = Nfft - i_sample;
+        if(count < n) n = count;
+        if(frames < (size_t)n) n = (int)frames;
+
+        deinterleave(src, nChannels, &x_cyclic_in[i_sample], Nfft, n);
+        if(trigger->GetMode()!=TRIGGER_OFF)
+            trigger->Process(&x_cyclic_in[i_sample], Nfft, n);
+        src += nChannels*n;
+        frames -= n;
+        i_sample += n;
+        count -= n;
+        sample_count += n;
+
+        if(i_sample==Nfft){
+            i_sample = 0;
+            memcpy(x_draw_raw[i_draw_back].get(), x_cyclic_in.get(),
+                sizeof(float)*Nfft*nChannels);
+            i_draw_front ^= 1;
+            i_draw_back ^= 1;
+        }
+
+        if(count==0){
+            count = Ncount;
+            if(frameFifo->GetNumReady()<(size_t)Nframes_fifo){
+                // linearize the cyclic buffer, oldest sample first
+                int N1 = Nfft - i_sample;
+                int N2 = i_sample;
+                for(int c=0;c<nChannels;c++){
+                    float *x = &x_in[(size_t)i_buffer*Nframe + c*Nfft];
+                    const float *x_cyclic = &x_cyclic_in[c*Nfft];
+                    memcpy(&x[0], &x_cyclic[i_sample], sizeof(float)*N1);
+                    memcpy(&x[N1], &x_cyclic[0], sizeof(float)*N2);
+                }
+                FrameDesc frame;
+                frame.index = i_buffer;
+                frame.flags = 0;
+                frame.timestamp = sample_count;
+                frame.sequence = frame_sequence++;
+                frameFifo->Push(frame);
+                analysis_sem.post();
+                i_buffer++;
+                if(i_buffer>Nframes_fifo)
+                    i_buffer=0;
             }
-            i_src = 0;
-            for(int i=0;i<N2;i++){
-                x_in_l[i_buffer][i_dst] = x_cyclic_in_l[i_src];
-                x_in_r[i_buffer][i_dst] = x_cyclic_in_r[i_src];
-                i_src++;
-                i_dst++;
+        }
+    }
+}
+
+/*
+    Queue spectra computed by the plugin, in the format of
+    SpectraFormat.h. Decimated spectra are expanded back to Npoints bins
+    and the lines go through the analysis worker so that the line fifo
+    keeps a single producer.
+*/
+void Spectrum::InsertSpectra(const uint16_t *spectra, int n_points)
+{
+    std::lock_guard<std::mutex> lock(config_mutex);
+    // the decimation is a power of two, anything else is a stale size
+    int D = 1;
+    while(D<Nfft && (Npoints-2)/D + 2 > n_points)
+        D <<= 1;
+    if((Npoints-2)/D + 2==n_points
+        && frameFifo->GetNumReady()<(size_t)Nframes_fifo){
+        for(int c=0;c<nChannels;c++){
+            const uint16_t *q = spectra + c*n_points;
+            float *X = &x_in[(size_t)i_buffer*Nframe + c*Npoints];
+            for(int k=0;k<Npoints;k++){
+                X[k] = spectra_dequantize(q[spectra_decimated_index(k, D)]);
             }
-            ptrFifo.Push(i_buffer);
-            i_buffer++;
-            if(i_buffer==Ncopy)
-                i_buffer=0;
+        }
+        FrameDesc frame;
+        frame.index = i_buffer;
+        frame.flags = FRAME_SPECTRA;
+        frame.timestamp = sample_count;
+        frame.sequence = frame_sequence++;
+        frameFifo->Push(frame);
+        analysis_sem.post();
+        i_buffer++;
+        if(i_buffer>Nframes_fifo)
+            i_buffer=0;
+    }
+}
+
+/*
+    Fill the time graph from the plugin's (min,max) envelope. Each pair
+    is spread over its share of the Nfft samples, alternating min and
+    max so that the trace covers the band.
+*/
+void Spectrum::InsertEnvelope(const float *envelope, int n_points)
+{
+    std::lock_guard<std::mutex> lock(config_mutex);
+    for(int c=0;c<nChannels;c++){
+        const float *env = envelope + c*n_points*2;
+        float *x = &x_draw_raw[i_draw_back][c*Nfft];
+        for(int i=0;i<Nfft;i++){
+            int p = (int)((int64_t)i*n_points/Nfft);
+            x[i] = env[p*2 + (i&1)];
         }
     }
+    i_draw_front ^= 1;
+    i_draw_back ^= 1;
 }
 
 glm::vec4 hsv2rgba(float hue, float sat, float val, float alpha)
@@ -306,21 +755,19 @@ glm::vec4 hsv2rgba(float hue, float sat, float val, float alpha)
     return glm::vec4(rgb, alpha);
 }
 
-void Spectrum::SetColors(float hue_l)
+void Spectrum::SetColors(float hue_first)
 {
-    float hue_r = hue_l + 180.0f;
-    if(hue_r>=360.0f)
-        hue_r -= 360.0f;
-    time_color_l0 = hsv2rgba(hue_l, 1.0f, 0.125f, 1.0f);
-    time_color_l1 = hsv2rgba(hue_l, 1.0f, 1.0f, 1.0f);
-    time_color_r0 = hsv2rgba(hue_r, 1.0f, 0.125f, 1.0f);
-    time_color_r1 = hsv2rgba(hue_r, 1.0f, 1.0f, 1.0f);
-    freq_color_l0 = hsv2rgba(hue_l, 1.0f, 0.25f, 1.0f);
-    freq_color_l1 = hsv2rgba(hue_l, 1.0f, 0.5f, 1.0f);
-    freq_color_r0 = hsv2rgba(hue_r, 1.0f, 0.25f, 1.0f);
-    freq_color_r1 = hsv2rgba(hue_r, 1.0f, 0.5f, 1.0f);
-    fill_color_l = hsv2rgba(hue_l, 1.0f, 0.5f, 1.0f);
-    fill_color_r = hsv2rgba(hue_r, 1.0f, 0.5f, 1.0f);
+    // the channels are spread evenly around the hue circle
+    for(int c=0;c<nChannels;c++){
+        float hue = hue_first + c*360.0f/nChannels;
+        if(hue>=360.0f)
+            hue -= 360.0f;
+        time_color0[c] = hsv2rgba(hue, 1.0f, 0.125f, 1.0f);
+        time_color1[c] = hsv2rgba(hue, 1.0f, 1.0f, 1.0f);
+        freq_color0[c] = hsv2rgba(hue, 1.0f, 0.25f, 1.0f);
+        freq_color1[c] = hsv2rgba(hue, 1.0f, 0.5f, 1.0f);
+        fill_color[c] = hsv2rgba(hue, 1.0f, 0.5f, 1.0f);
+    }
 }
 
 void Spectrum::SetFrequency(bool log)
@@ -328,6 +775,60 @@ void Spectrum::SetFrequency(bool log)
     Spectrum::log = log;
 }
 
+void Spectrum::SetWindow(int type)
+{
+    window_type = FFTWindow::Validate(type);
+}
+
+void Spectrum::SetInterpolate(bool interpolate)
+{
+    Spectrum::interpolate = interpolate;
+    map_valid = false;
+}
+
+void Spectrum::GetGraphTime(uint64_t &ns, uint64_t &frames)
+{
+    ns = std::chrono::duration_cast<std::chrono::nanoseconds>(graph_time).count();
+    frames = graph_frames;
+}
+
+void Spectrum::SetTrigger(const TriggerSettings &settings)
+{
+    // excludes EvaluateBlock
+    std::lock_guard<std::mutex> lock(config_mutex);
+    trigger->Set(settings);
+}
+
+void Spectrum::RearmTrigger(void)
+{
+    std::lock_guard<std::mutex> lock(config_mutex);
+    trigger->Rearm();
+}
+
+void Spectrum::SetWaterfallHistory(float seconds)
+{
+    if(seconds==waterfall_history)
+        return;
+    waterfall_history = seconds;
+    history_pending = true;
+}
+
+void Spectrum::SetWaterfallPaused(bool paused)
+{
+    waterfall_paused = paused;
+}
+
+void Spectrum::ScrollWaterfall(int lines)
+{
+    if(waterfall)
+        waterfall->Scroll(lines);
+}
+
+void Spectrum::SetStereoMode(StereoMode mode)
+{
+    stereo_mode = mode;
+}
+
 void Spectrum::InitializeFrequency(void)
 {
     if(!log){
@@ -347,55 +848,88 @@ void Spectrum::InitializeFrequency(void)
             x_points[i] = f;
         }
     }
-    //fill->SetX(x.get());
-    //lgraph->SetX(x.get());
-    waterfall->InitializeFrequency(log);
+    map_valid = false;
     grid->SetFrequency(log);
 }
 
-void Spectrum::CoalescePoints(int pix_width)
+// inverse of the frequency scale, the bin at plot position x
+float Spectrum::BinAt(float x)
 {
-    float db_max_l = X_db_l[0];
-    float db_max_r = X_db_r[0];
-    int i_p=0;
-    float pix_threshold = floorf(x_points[0]*pix_width + 1.0f);
-    float alpha0 = 0.0f;
-    for(int i=1;i<Npoints;i++){
-        float pix = x_points[i]*pix_width/alpha_width;
-        if(pix>=pix_threshold 
-            || i==(Npoints-1)
-            || pix >= pix_width)
-        {
-            x_points_p[i_p] = alpha0;
-            X_db_l_p[i_p] = db_max_l;
-            X_db_r_p[i_p] = db_max_r;
-            db_max_l = X_db_l[i];
-            db_max_r = X_db_r[i];
-            i_p++;
-            alpha0 = x_points[i];
-            if(pix>=pix_width)
-                break;
-            pix_threshold = floorf(pix+1.0f);
-        } else {
-            if(X_db_l[i]>db_max_l){
-                db_max_l = X_db_l[i];
-            }
-            if(X_db_r[i]>db_max_r){
-                db_max_r = X_db_r[i];
+    if(!log)
+        return x*(Npoints-1);
+    float alpha2 = logf(2.0f)/logf((float)Npoints);
+    float beta = alpha2/(1.0f + alpha2);
+    if(x < beta)
+        return x/beta;
+    return expf((x - beta)/(1.0f - beta)*logf((float)Npoints));
+}
+
+/*
+    Each plotted point starts a new pixel column. Where several bins fall
+    in a column the point is their peak; where neighbouring bins are
+    more than a pixel apart, points are interpolated in the columns
+    between them. One point past the right edge is kept so that the
+    graph reaches it.
+*/
+void Spectrum::BuildPointMap(int pix_width)
+{
+    float scale = pix_width/alpha_width;
+    bool interp = interpolate && pix_width <= SPECTRUM_PIXELS_MAX;
+    int n = 0;
+    int i = 0;
+    while(i < Npoints-1){
+        float u0 = x_points[i]*scale;
+        float u1 = x_points[i+1]*scale;
+        bool sparse = interp && u1 - u0 > 1.0f;
+        int i1 = i + 1;
+        if(!sparse){
+            float u_next = floorf(u0) + 1.0f;
+            while(i1 < Npoints-1 && x_points[i1]*scale < u_next)
+                i1++;
+        }
+        point_map[n] = {i, i1, 0.0f};
+        x_points_p[n] = x_points[i];
+        n++;
+        if(u0 >= pix_width)
+            break;
+        if(sparse){
+            for(float u=floorf(u0)+1.0f;u<floorf(u1) && u<pix_width;u+=1.0f){
+                float x = u/scale;
+                float t = BinAt(x) - i;
+                if(t < 0.0f) t = 0.0f;
+                if(t > 1.0f) t = 1.0f;
+                point_map[n] = {i, i, t};
+                x_points_p[n] = x;
+                n++;
             }
         }
+        i = i1;
     }
-    Npoints_p = i_p;
+    Npoints_p = n;
+    map_width = pix_width;
+    map_valid = true;
+    lgraph->SetX(x_points_p.get(), Npoints_p);
+    waterfall->SetColumns(point_map.get(), x_points_p.get(), Npoints_p);
+}
+
+void Spectrum::CoalescePoints(int pix_width)
+{
+    if(!map_valid || pix_width!=map_width)
+        BuildPointMap(pix_width);
+
+    for(int c=0;c<nChannels;c++)
+        PoolPoints(point_map.get(), Npoints_p, &X_db[c*Npoints], Npoints,
+                   &X_db_p[c*Npoints_p_max]);
 }
 
-void Spectrum::ShadeGraph(std::unique_ptr<float[]> &x_raw, int width_pix, int height_pix)
+void Spectrum::ShadeGraph(const float *x_raw, int N, int width_pix, int height_pix)
 {
-    float pix_per_sample_x = (float)width_pix/Nfft;
+    float pix_per_sample_x = (float)width_pix/N;
     float pix_per_unit_y = (float)height_pix/2.0f/5.0f;
     float pix_per_sample_x2 = pix_per_sample_x*pix_per_sample_x;
 
     // compute the deltas in pixels
-    for(int i=0;i<Nfft-1;i++){
+    for(int i=0;i<N-1;i++){
         dx_draw_raw[i] = (x_raw[i+1] - x_raw[i])*pix_per_unit_y;
     }
 
@@ -403,7 +937,7 @@ void Spectrum::ShadeGraph(std::unique_ptr<float[]> &x_raw, int width_pix, int he
     float v_min = 1.0f/10.0f;
     float v0;
     int i;
-    for(i=0;i<Nfft-1;i++){
+    for(i=0;i<N-1;i++){
         x_draw[i*2] = x_raw[i];
         x_draw[i*2+1] = (x_raw[i]+x_raw[i+1])/2.0f;
         // compute the length of the line
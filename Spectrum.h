@@ -29,50 +29,46 @@
 
 #pragma once
 
-#include <complex>
-#include <fftw3.h>
 #include <memory>
 #include <iostream>
-#include <deque>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include <chrono>
+#include <mutex>
 #include "TGraph.h"
 #include "LGraph.h"
 #include "GraphFill.h"
 #include "Waterfall.h"
 #include "Grid.h"
 #include "Semaphore.h"
-
-struct PtrFifo
+#include "FFTWindow.h"
+#include "FFT.h"
+#include "SpscRing.h"
+#include "SpectraFormat.h"
+#include "MinMaxPyramid.h"
+#include "Trigger.h"
+#include "StreamBuffer.h"
+#include "PointMap.h"
+
+// largest host block the capture fifo is sized for
+#define MAX_BLOCK_FRAMES 8192
+// most frames analysed by one batched transform, and the samples a
+// batch may hold across all its channels
+#define BATCH_FRAMES_MAX  8
+#define BATCH_SAMPLES_MAX 262144
+// widest plot, in pixels, that sparse bins are interpolated across
+#define SPECTRUM_PIXELS_MAX 8192
+// above this many samples per pixel the time graph is drawn as its
+// min/max band
+#define TIME_BAND_SAMPLES_PER_PIXEL 2
+// most samples the time graph draws as a shaded line
+#define TIME_SHADE_MAX (TIME_BAND_SAMPLES_PER_PIXEL*SPECTRUM_PIXELS_MAX)
+
+enum StereoMode
 {
-private:
-    std::deque<int> fifo;
-    Semaphore sem;
-
-public:
-    PtrFifo() : sem(1)
-    {
-
-    }
-
-    void Push(int i)
-    {
-        sem.wait();
-        fifo.push_back(i);
-        sem.post();
-    }
-    
-    int Pop(void)
-    {
-        sem.wait();
-        int r = fifo.front();
-        fifo.pop_front();
-        sem.post();
-        return r;
-    }
-
-    int GetNumReady(void)
-    {
-        return fifo.size();
-    }
+    STEREO_SEPARATE = 0, // one batched real FFT of every channel per hop
+    STEREO_PACKED        // channels paired into complex FFTs, split afterwards
 };
 
 class Spectrum
@@ -80,30 +76,53 @@ class Spectrum
 public:
     Spectrum(
         int Nfft,
+        int nChannels,
         double fsamplerate,
         float frame_rate,
         int Ncopy,
-        const char* bundle_path);
+        const char* bundle_path,
+        FFTPrecision precision = FFT_FLOAT);
     ~Spectrum();
     
     void GLInit(void);
     void GLDestroy(void);
     void Render(void);
-    void EvaluateSample(float xl, float xr);
+    void EvaluateBlock(const float *interleaved, size_t frames);
+    void InsertSpectra(const uint16_t *spectra, int n_points);
+    void InsertEnvelope(const float *envelope, int n_points);
     void SetdBLimits(float dB_min, float dB_max);
     void SetWidth(float frequency);
-    void SetColors(float hue_left);
+    void SetColors(float hue_first);
     void SetFrequency(bool log=false);
+    void SetInterpolate(bool interpolate);
+    void SetWindow(int type);
+    void SetStereoMode(StereoMode mode);
+    void SetFFT(int Nfft, int Ncopy);
+    void GetAnalysisCounts(uint64_t &produced, uint64_t &consumed);
+    bool GetWisdomHit(void);
+    void SetDropped(uint64_t dropped);
+    // CPU time spent in the graph classes and the frames it covers
+    void GetGraphTime(uint64_t &ns, uint64_t &frames);
+    void SetTrigger(const TriggerSettings &settings);
+    void RearmTrigger(void);
+    // seconds of waterfall history, applied by the next Render
+    void SetWaterfallHistory(float seconds);
+    // applied by the next Render
+    void SetWaterfallPaused(bool paused);
+    // lines back through the history while paused
+    void ScrollWaterfall(int lines);
     
 private:
     int Nfft;
-    int Nfft_draw;
+    int nChannels;
+    // vertices of the shaded time graph, and the count its x is set for
+    int Ntime_draw;
     int Ndx_draw;
+    int Ntime_x;
     int Npoints;
     int Npoints_p;
     int Ncopy;
     const char* bundle_path;
-    int index_last;
     int i_buffer;
     int i_sample;
     int Ncount;
@@ -113,49 +132,124 @@ private:
     bool log;
     bool log_last;
     float alpha_width;
-    glm::vec4 time_color_l0;
-    glm::vec4 time_color_l1;
-    glm::vec4 time_color_r0;
-    glm::vec4 time_color_r1;
-    glm::vec4 freq_color_l0;
-    glm::vec4 freq_color_l1;
-    glm::vec4 freq_color_r0;
-    glm::vec4 freq_color_r1;
-    glm::vec4 fill_color_l;
-    glm::vec4 fill_color_r;
+    float dB_min;
+    float dB_max;
+    uint64_t dropped;
+    // one color per channel
+    std::unique_ptr<glm::vec4[]> time_color0;
+    std::unique_ptr<glm::vec4[]> time_color1;
+    std::unique_ptr<glm::vec4[]> freq_color0;
+    std::unique_ptr<glm::vec4[]> freq_color1;
+    std::unique_ptr<glm::vec4[]> fill_color;
     double fsamplerate;
     float frame_rate;
-    std::unique_ptr<float[]> x_cyclic_in_l;
-    std::unique_ptr<float[]> x_cyclic_in_r;
-    std::unique_ptr<std::unique_ptr<float[]>[]> x_draw_l_raw;
-    std::unique_ptr<std::unique_ptr<float[]>[]> x_draw_r_raw;
+    FFTPrecision precision;
+    // The sample and spectrum buffers hold every channel, channel-major:
+    // channel c of a buffer of Nfft samples starts at c*Nfft, of a
+    // spectrum at c*Npoints.
+    std::unique_ptr<float[]> x_cyclic_in;
+    std::unique_ptr<std::unique_ptr<float[]>[]> x_draw_raw;
     std::unique_ptr<float[]> dx_draw_raw;
     std::unique_ptr<float[]> x_draw;
     std::unique_ptr<float[]> v_draw;
-    std::unique_ptr<std::unique_ptr<float[]>[]> x_in_l;
-    std::unique_ptr<std::unique_ptr<float[]>[]> x_in_r;
-    std::unique_ptr<double[]> x_fft;
+    // the time graph as a min/max band, one column per pixel
+    std::unique_ptr<MinMaxPyramid> time_pyramid;
+    std::unique_ptr<float[]> band_min;
+    std::unique_ptr<float[]> band_max;
+    // the time graph shows the triggered window when the trigger is on,
+    // copied out under config_mutex when the trigger has a new one
+    std::unique_ptr<Trigger> trigger;
+    std::unique_ptr<float[]> x_trigger;
+    size_t x_trigger_size;
+    int N_trigger;
+    uint64_t trigger_count;
+    // the capture buffers, Nframes_fifo+1 frames of Nframe samples in
+    // one block so that consecutive frames can be transformed together
+    int Nframe;
+    std::unique_ptr<float[]> x_in;
     bool dataReady;
-    std::unique_ptr<std::complex<double>[]> X_fft;
-    fftw_plan x_plan;
-    std::unique_ptr<float[]> X_db_l;
-    std::unique_ptr<float[]> X_db_r;
+    std::unique_ptr<FFT> fft;
+    std::unique_ptr<float[]> X_pow;
+    // Nbatch frames of every channel as one plan, used when the worker
+    // finds that many frames waiting
+    int Nbatch;
+    std::unique_ptr<FFT> batch_fft;
+    FrameDesc batch[BATCH_FRAMES_MAX];
+    // set from the host thread, read by the analysis worker
+    std::atomic<StereoMode> stereo_mode;
+    std::atomic<int> window_type;
+    std::unique_ptr<FFTWindow> windows[WINDOW_NTYPES];
+    std::unique_ptr<float[]> X_db;
     std::unique_ptr<float[]> x_points;
-    std::unique_ptr<float[]> X_db_l_p;
-    std::unique_ptr<float[]> X_db_r_p;
+    std::unique_ptr<float[]> X_db_p;
     std::unique_ptr<float[]> x_points_p;
-    PtrFifo ptrFifo;
+    // the bins of each plotted point, rebuilt by BuildPointMap only when
+    // the plot width, view width, scale or interpolation change
+    int Npoints_p_max;
+    std::unique_ptr<PointSpan[]> point_map;
+    int map_width;
+    bool map_valid;
+    bool interpolate;
+    // reconfiguration, requested by SetFFT and applied by Render
+    std::mutex config_mutex;
+    std::atomic<bool> config_pending;
+    std::atomic<int> Nfft_pending;
+    std::atomic<int> Ncopy_pending;
+    // waterfall settings from the host thread, applied by Render
+    std::atomic<float> waterfall_history;
+    std::atomic<bool> waterfall_paused;
+    bool waterfall_paused_last;
+    std::atomic<bool> history_pending;
+
+    int Nframes_fifo;
+    uint64_t sample_count;
+    uint64_t frame_sequence;
+    std::unique_ptr<SpscRing<FrameDesc>> frameFifo;
+
+    // analysis worker, consumes frameFifo and produces dB lines
+    std::thread analysis_thread;
+    Semaphore analysis_sem;
+    std::atomic<bool> analysis_quit;
+    std::atomic<uint64_t> frames_produced;
+    std::atomic<uint64_t> frames_consumed;
+    int Nlines_fifo;
+    int i_line_buffer;
+    // Nlines_fifo+1 lines of Nline dB values in one block
+    int Nline;
+    std::unique_ptr<float[]> X_db_lines;
+    std::unique_ptr<const float*[]> line_ptrs;
+    std::unique_ptr<SpscRing<FrameDesc>> lineFifo;
     
     std::unique_ptr<LGraph> lgraph;
     std::unique_ptr<TGraph> tgraph;
     std::unique_ptr<GraphFill> fill;
+    // where each channel's spectrum line went in the stream buffer,
+    // the fill is drawn from the same data
+    std::unique_ptr<GLintptr[]> line_offset;
     std::unique_ptr<Waterfall> waterfall;
+    void CreateWaterfall(void);
     std::unique_ptr<Grid> grid;
+    // vertex data of the graphs, streamed each frame
+    std::unique_ptr<StreamBuffer> stream;
+    std::chrono::steady_clock::duration graph_time;
+    uint64_t graph_frames;
     
-    void ComputeSpectrum(float *x, std::unique_ptr<float[]> &X_db);
+    FFTWindow* GetWindow(void);
+    float PowerNorm(FFTWindow *window);
+    void PowerTodB(const float *X_pow, float *X_db, float norm2);
+    void ComputeSpectra(const float *x, float *X_db);
+    void AnalyseFrame(const FrameDesc &frame);
+    void AnalyseBatch(int n);
+    void AnalysisLoop(void);
+    void Allocate(void);
+    void StartAnalysis(void);
+    void StopAnalysis(void);
+    void Reconfigure(void);
     void InitializeFrequency(void);
+    float BinAt(float x);
+    void BuildPointMap(int pix_width);
     void CoalescePoints(int pix_width);
-    void ShadeGraph(std::unique_ptr<float[]> &x_raw, int width_pix, int height_pix);
+    void ShadeGraph(const float *x_raw, int N, int width_pix, int height_pix);
 };
 
 
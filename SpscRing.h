@@ -0,0 +1,148 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  ==============================================================================
+
+    SpscRing.h
+
+    Bounded lock-free single-producer/single-consumer ring. The producer
+    owns head and the consumer owns tail; each is published with a
+    release store and read by the other side with an acquire load. The
+    indices live on separate cache lines so the two threads don't
+    false-share.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#define SPSC_CACHE_LINE 64
+
+// the frame buffers hold dB spectra computed by the plugin
+#define FRAME_SPECTRA 0x1
+
+// descriptor of a captured or analysed frame
+struct FrameDesc
+{
+    int      index;     // buffer index
+    uint32_t flags;     // FRAME_ flags
+    uint64_t timestamp; // sample count at the end of the frame
+    uint64_t sequence;  // frame number
+};
+
+template<typename T>
+class SpscRing
+{
+    // producer side
+    alignas(SPSC_CACHE_LINE) std::atomic<size_t> head;
+    size_t tail_cache;
+
+    // consumer side
+    alignas(SPSC_CACHE_LINE) std::atomic<size_t> tail;
+    size_t head_cache;
+
+    // shared, read only
+    alignas(SPSC_CACHE_LINE) size_t capacity;
+    size_t mask;
+    std::unique_ptr<T[]> slots;
+
+public:
+    // the capacity is rounded up to a power of two
+    SpscRing(size_t min_capacity)
+    {
+        capacity = 1;
+        while(capacity < min_capacity)
+            capacity <<= 1;
+        mask = capacity - 1;
+        slots.reset(new T[capacity]);
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+        tail_cache = 0;
+        head_cache = 0;
+    }
+
+    size_t GetCapacity(void) const
+    {
+        return capacity;
+    }
+
+    // producer only, returns false when the ring is full
+    bool Push(const T &value)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if(h - tail_cache == capacity){
+            tail_cache = tail.load(std::memory_order_acquire);
+            if(h - tail_cache == capacity)
+                return false;
+        }
+        slots[h & mask] = value;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only, returns false when the ring is empty
+    bool Pop(T &value)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if(t == head_cache){
+            head_cache = head.load(std::memory_order_acquire);
+            if(t == head_cache)
+                return false;
+        }
+        value = slots[t & mask];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only, the value i places from the tail without removing
+    // it, returns false when fewer than i+1 values are ready
+    bool Peek(size_t i, T &value)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if(head_cache - t <= i){
+            head_cache = head.load(std::memory_order_acquire);
+            if(head_cache - t <= i)
+                return false;
+        }
+        value = slots[(t + i) & mask];
+        return true;
+    }
+
+    // consumer only, remove n values already seen with Peek. Until then
+    // the producer can't reuse their slots, or any buffer they refer to.
+    void Advance(size_t n)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        tail.store(t + n, std::memory_order_release);
+    }
+
+    // safe from either side, exact for the caller's own view
+    size_t GetNumReady(void) const
+    {
+        size_t t = tail.load(std::memory_order_acquire);
+        size_t h = head.load(std::memory_order_acquire);
+        return h - t;
+    }
+};
@@ -0,0 +1,111 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  ==============================================================================
+
+    StreamBuffer.cpp
+
+  ==============================================================================
+*/
+
+#include "StreamBuffer.h"
+#include <stdio.h>
+
+// one second, in ns
+#define STREAM_BUFFER_WAIT 1000000000
+
+StreamBuffer::StreamBuffer(size_t region_bytes)
+    :region_size((region_bytes + STREAM_BUFFER_ALIGN - 1)
+                 & ~(size_t)(STREAM_BUFFER_ALIGN - 1)),
+    region(0),
+    offset(0)
+{
+    for(int r=0;r<STREAM_BUFFER_REGIONS;r++)
+        fences[r] = 0;
+
+    const GLbitfield flags = GL_MAP_WRITE_BIT
+                           | GL_MAP_PERSISTENT_BIT
+                           | GL_MAP_COHERENT_BIT;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferStorage(GL_ARRAY_BUFFER, region_size*STREAM_BUFFER_REGIONS,
+                    NULL, flags);
+    map = (char*)glMapBufferRange(GL_ARRAY_BUFFER, 0,
+                                  region_size*STREAM_BUFFER_REGIONS, flags);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if(!map)
+        printf("StreamBuffer: Error, couldn't map %zu bytes.\n",
+               region_size*STREAM_BUFFER_REGIONS);
+}
+
+StreamBuffer::~StreamBuffer(void)
+{
+    for(int r=0;r<STREAM_BUFFER_REGIONS;r++){
+        if(fences[r])
+            glDeleteSync(fences[r]);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glDeleteBuffers(1, &buffer);
+}
+
+void StreamBuffer::BeginFrame(void)
+{
+    region = (region + 1) % STREAM_BUFFER_REGIONS;
+    offset = 0;
+    GLsync fence = fences[region];
+    if(!fence)
+        return;
+    // normally signalled long ago, two frames have passed since
+    GLenum status = glClientWaitSync(fence, 0, 0);
+    while(status==GL_TIMEOUT_EXPIRED){
+        status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                  STREAM_BUFFER_WAIT);
+    }
+    glDeleteSync(fence);
+    fences[region] = 0;
+}
+
+void StreamBuffer::EndFrame(void)
+{
+    if(fences[region])
+        glDeleteSync(fences[region]);
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void* StreamBuffer::Allocate(size_t bytes, GLintptr &offset)
+{
+    if(!map)
+        return nullptr;
+    size_t start = (StreamBuffer::offset + STREAM_BUFFER_ALIGN - 1)
+                 & ~(size_t)(STREAM_BUFFER_ALIGN - 1);
+    if(start + bytes > region_size){
+        if(bytes > region_size)
+            return nullptr;
+        // The region is full. Reuse it from the start once the draws
+        // already made from it have completed.
+        glFinish();
+        start = 0;
+    }
+    StreamBuffer::offset = start + bytes;
+    offset = (GLintptr)(region*region_size + start);
+    return map + offset;
+}
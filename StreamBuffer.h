@@ -0,0 +1,73 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  ==============================================================================
+
+    StreamBuffer.h
+
+    Per frame vertex data for the graphs. One buffer is created with
+    glBufferStorage and mapped once, persistent and coherent, and split
+    into STREAM_BUFFER_REGIONS regions used in turn by successive
+    frames. Each frame's draws are fenced; a region is only written
+    again after its fence has signalled, so the graphs copy their data
+    straight into memory the GPU reads without mapping, orphaning or
+    waiting on the draws of the frame in flight.
+
+    The graphs take space with Allocate and source their attributes
+    from GetBuffer at the returned offset with glBindVertexBuffer, or
+    bind it as a shader storage buffer with glBindBufferRange. The
+    waterfall keeps one of its own as a pixel unpack buffer for its
+    texture uploads.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <glad/gl.h>
+#include <stddef.h>
+
+#define STREAM_BUFFER_REGIONS 3
+// alignment of each allocation, enough for any vertex attribute and
+// the largest GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT the spec allows
+#define STREAM_BUFFER_ALIGN   256
+
+class StreamBuffer
+{
+    GLuint buffer;
+    size_t region_size;
+    char *map;
+    GLsync fences[STREAM_BUFFER_REGIONS];
+    int region;
+    size_t offset;
+
+public:
+    // region_bytes is rounded up to STREAM_BUFFER_ALIGN
+    StreamBuffer(size_t region_bytes);
+    ~StreamBuffer(void);
+
+    // move to the next region, waiting for the GPU to be done with it
+    void BeginFrame(void);
+    // fence the draws that used the current region
+    void EndFrame(void);
+    // bytes of the current region, offset is from the start of the buffer
+    void* Allocate(size_t bytes, GLintptr &offset);
+    GLuint GetBuffer(void) { return buffer; }
+};
@@ -65,8 +65,10 @@ void TGraph::ProgramDestroy(void)
     glDeleteProgram(programObject);
 }
 
-TGraph::TGraph(int Nvertices)
-    :Nvertices(Nvertices),
+TGraph::TGraph(int Nvertices, StreamBuffer *stream)
+    :stream(stream),
+    v_offset(-1),
+    Nvertices(Nvertices),
     lineWidth0(1.0),
     lineWidth1(3.0),
     ytop(1.0),
@@ -75,8 +77,6 @@ TGraph::TGraph(int Nvertices)
     ProgramLoad();
 
     glGenBuffers(1, &xVBO);
-    glGenBuffers(1, &yVBO);
-    glGenBuffers(1, &vVBO);
 
     glBindBuffer(GL_ARRAY_BUFFER, xVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(float)*Nvertices,
@@ -92,30 +92,15 @@ TGraph::TGraph(int Nvertices)
 
     glUnmapBuffer(GL_ARRAY_BUFFER);
 
-    glBindBuffer(GL_ARRAY_BUFFER, yVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float)*Nvertices,
-                 NULL, GL_STREAM_DRAW);
-
-    glBindBuffer(GL_ARRAY_BUFFER, vVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float)*Nvertices,
-                NULL, GL_DYNAMIC_DRAW);
-             
-    glGenVertexArrays(1, &VAO);
-
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, xVBO);
-    glVertexAttribPointer(X_LOC, 1, GL_FLOAT, GL_FALSE, 0, NULL);
+    // the band interleaves x and y in one binding
+    glGenVertexArrays(1, &bandVAO);
+    glBindVertexArray(bandVAO);
+    glVertexAttribFormat(X_LOC, 1, GL_FLOAT, GL_FALSE, 0);
+    glVertexAttribBinding(X_LOC, 0);
     glEnableVertexAttribArray(X_LOC);
-
-    glBindBuffer(GL_ARRAY_BUFFER, yVBO);
-    glVertexAttribPointer(Y_LOC, 1, GL_FLOAT, GL_FALSE, 0, NULL);
+    glVertexAttribFormat(Y_LOC, 1, GL_FLOAT, GL_FALSE, sizeof(float));
+    glVertexAttribBinding(Y_LOC, 0);
     glEnableVertexAttribArray(Y_LOC);
-
-    glBindBuffer(GL_ARRAY_BUFFER, vVBO);
-    glVertexAttribPointer(V_LOC, 1, GL_FLOAT, GL_FALSE, 0, NULL);
-    glEnableVertexAttribArray(V_LOC);
-
     glBindVertexArray(0);
     
     view_width = 1.0f;
@@ -127,8 +112,7 @@ TGraph::~TGraph(void)
     ProgramDestroy();
 
     glDeleteBuffers(1, &xVBO);
-    glDeleteBuffers(1, &yVBO);
-    glDeleteVertexArrays(1, &VAO);
+    glDeleteVertexArrays(1, &bandVAO);
 }
 
 void TGraph::SetColors(glm::vec4 &color0, glm::vec4 &color1){
@@ -156,13 +140,20 @@ void TGraph::SetViewWidth(float width)
 void TGraph::SetX(float *x, int N)
 {
     glBindBuffer(GL_ARRAY_BUFFER, xVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(float)*N, x);
+}
+
+void TGraph::SetXLinear(int N)
+{
+    // only when the window length changes
+    glBindBuffer(GL_ARRAY_BUFFER, xVBO);
 
     float *xVBOmap = (float*)glMapBufferRange(GL_ARRAY_BUFFER,
                                               0, sizeof(float)*N,
                                               GL_MAP_WRITE_BIT|
                                               GL_MAP_INVALIDATE_BUFFER_BIT);
     for(int i=0;i<N;i++){
-        xVBOmap[i] = x[i];
+        xVBOmap[i] = ((float)i/(N-1));
     }
 
     glUnmapBuffer(GL_ARRAY_BUFFER);
@@ -170,17 +161,12 @@ void TGraph::SetX(float *x, int N)
 
 void TGraph::SetValue(float *v, int N)
 {
-    glBindBuffer(GL_ARRAY_BUFFER, vVBO);
-
-    float *vVBOmap = (float*)glMapBufferRange(GL_ARRAY_BUFFER,
-                                              0, sizeof(float)*N,
-                                              GL_MAP_WRITE_BIT|
-                                              GL_MAP_INVALIDATE_BUFFER_BIT);
-    for(int i=0;i<N;i++){
-        vVBOmap[i] = v[i];
+    float *vmap = (float*)stream->Allocate(sizeof(float)*N, v_offset);
+    if(!vmap){
+        v_offset = -1;
+        return;
     }
-
-    glUnmapBuffer(GL_ARRAY_BUFFER);
+    memcpy(vmap, v, sizeof(float)*N);
 }
 
 
@@ -189,19 +175,11 @@ void TGraph::Draw(float *y0, int N)
     //glEnable(GL_BLEND);
     //glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    glBindBuffer(GL_ARRAY_BUFFER, yVBO);
-
-    float *yVBOmap = (float*)glMapBufferRange(GL_ARRAY_BUFFER,
-                                              0, sizeof(float)*N,
-                                              GL_MAP_WRITE_BIT|
-                                              GL_MAP_INVALIDATE_BUFFER_BIT);
-    memcpy(yVBOmap, y0, sizeof(float)*N);
-
-    glUnmapBuffer(GL_ARRAY_BUFFER);
-
-    glUseProgram(programObject);
-
-    glBindVertexArray(VAO);
+    GLintptr offset;
+    float *y = (float*)stream->Allocate(sizeof(float)*N, offset);
+    if(!y)
+        return;
+    memcpy(y, y0, sizeof(float)*N);
 
     float top = ytop;
     float bottom = ybottom;
@@ -211,19 +189,51 @@ void TGraph::Draw(float *y0, int N)
     float far = -1.0f;
     glm::mat4 projection = glm::ortho(left, right, bottom, top, near, far);
 
-    glUniformMatrix4fv(projectionLocation, 1, GL_FALSE, glm::value_ptr(projection));
+    // the glow and the core in one draw, without SetValue this frame
+    // the trace is unshaded
+    const glm::vec4 colors[2] = {color0, color1};
+    const float widths[2] = {lineWidth0, lineWidth1};
+    GLuint v_buffer = v_offset >= 0 ? stream->GetBuffer() : 0;
+    line.Draw(projection, xVBO, 0, stream->GetBuffer(), offset,
+              v_buffer, v_offset, N, colors, widths);
+    v_offset = -1;
+}
 
-    glUniform4fv(colorLocation, 1, glm::value_ptr(color0));
-    glLineWidth(lineWidth0);
-    glDrawArrays(GL_LINE_STRIP, 0, N);
+void TGraph::DrawBand(const float *y_min, const float *y_max, int N, int height_pix)
+{
+    float pix = (ytop - ybottom)/(height_pix > 0 ? height_pix : 1);
+    float pad0 = 0.5f*lineWidth0*pix;
+    float pad1 = 0.5f*lineWidth1*pix;
+
+    glUseProgram(programObject);
+    glBindVertexArray(bandVAO);
 
-    glUniform4fv(colorLocation, 1, glm::value_ptr(color1));
-    glLineWidth(lineWidth1);
-    glDrawArrays(GL_LINE_STRIP, 0, N);
+    glm::mat4 projection = glm::ortho(0.0f, view_width, ybottom, ytop, 1.0f, -1.0f);
+    glUniformMatrix4fv(projectionLocation, 1, GL_FALSE, glm::value_ptr(projection));
+    // the band has no shading
+    glVertexAttrib1f(V_LOC, 1.0f);
+
+    // two vertices per column
+    const glm::vec4 *colors[2] = {&color0, &color1};
+    const float pads[2] = {pad0, pad1};
+    for(int pass=0;pass<2;pass++){
+        GLintptr offset;
+        float *band = (float*)stream->Allocate(sizeof(float)*4*N, offset);
+        if(!band)
+            break;
+        for(int i=0;i<N;i++){
+            float x = (i + 0.5f)/N;
+            band[4*i]   = x;
+            band[4*i+1] = y_min[i] - pads[pass];
+            band[4*i+2] = x;
+            band[4*i+3] = y_max[i] + pads[pass];
+        }
+        glBindVertexBuffer(0, stream->GetBuffer(), offset, 2*sizeof(float));
+
+        glUniform4fv(colorLocation, 1, glm::value_ptr(*colors[pass]));
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 2*N);
+    }
 
     glBindVertexArray(0);
     glUseProgram(0);
 }
-
-
-
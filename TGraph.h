@@ -22,6 +22,8 @@
 
 #include <glad/gl.h>
 #include <glm/glm.hpp>
+#include "StreamBuffer.h"
+#include "ThickLine.h"
 
 #define X_LOC 0
 #define Y_LOC 1
@@ -33,9 +35,13 @@ class TGraph
     GLint  colorLocation;
     GLint  projectionLocation;
     GLuint xVBO;
-    GLuint yVBO;
-    GLuint vVBO;
-    GLuint VAO;
+    // the trace, the band is drawn with programObject
+    ThickLine line;
+    // y, the shading values and the band, (x,y) pairs for a triangle
+    // strip, are written to the stream buffer each frame
+    StreamBuffer *stream;
+    GLintptr v_offset;
+    GLuint bandVAO;
     int Nvertices;
     glm::vec4 color0;
     glm::vec4 color1;
@@ -49,14 +55,20 @@ class TGraph
     void ProgramDestroy(void);
 
 public:
-    TGraph(int Nvertices);
+    TGraph(int Nvertices, StreamBuffer *stream);
     ~TGraph(void);
     void SetColors(glm::vec4 &color0, glm::vec4 &color1);
     void SetLineWidths(float lineWidth0, float lineWidth1);
     void SetLimits(float ytop, float ybottom);
     void SetViewWidth(float width);
     void SetX(float *x, int N);
+    // N vertices evenly spaced from 0 to 1
+    void SetXLinear(int N);
+    // the shading of the next Draw
     void SetValue(float *v, int N);
     void Draw(float *y, int N);
+    // fill between y_min and y_max over N equal columns, each color
+    // padded to its line width so that a flat band stays visible
+    void DrawBand(const float *y_min, const float *y_max, int N, int height_pix);
 };
 
@@ -0,0 +1,158 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+/*
+  ==============================================================================
+
+    ThickLine.cpp
+
+  ==============================================================================
+*/
+
+#include "ThickLine.h"
+#include "Shader.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <stdio.h>
+
+void ThickLine::ProgramLoad(void)
+{
+    // Six vertices per segment, two triangles between the ends p0 and
+    // p1 offset by the normal to either side. The quad runs one pixel
+    // wider than the line for the anti-aliased edge and stops at the
+    // ends, like a wide GL line, so that neighbouring segments do not
+    // cover each other twice under the additive blend.
+    const char *vertShaderSrc =
+        "#version 460\n"
+        "layout(std430, binding=0) readonly buffer XBuffer { float x[]; };\n"
+        "layout(std430, binding=1) readonly buffer YBuffer { float y[]; };\n"
+        "layout(std430, binding=2) readonly buffer VBuffer { float v[]; };\n"
+        "uniform mat4 projection;\n"
+        "uniform vec2 viewport;\n"
+        "uniform float widths[2];\n"
+        "uniform vec4 colors[2];\n"
+        "uniform bool shaded;\n"
+        "out vec4 color;\n"
+        "out float across;\n"
+        "flat out float half_width;\n"
+        "const int ends[6] = int[6](0, 1, 1, 0, 1, 0);\n"
+        "const float sides[6] = float[6](-1.0, -1.0, 1.0, -1.0, 1.0, 1.0);\n"
+        "void main()\n"
+        "{\n"
+        "   int s = gl_VertexID/6;\n"
+        "   int corner = gl_VertexID - 6*s;\n"
+        "   int end = ends[corner];\n"
+        "   vec4 c0 = projection*vec4(x[s], y[s], 0.0, 1.0);\n"
+        "   vec4 c1 = projection*vec4(x[s+1], y[s+1], 0.0, 1.0);\n"
+        "   vec2 p0 = (c0.xy*0.5 + 0.5)*viewport;\n"
+        "   vec2 p1 = (c1.xy*0.5 + 0.5)*viewport;\n"
+        "   vec2 d = p1 - p0;\n"
+        "   float len = length(d);\n"
+        "   d = len > 1e-6 ? d/len : vec2(1.0, 0.0);\n"
+        "   vec2 n = vec2(-d.y, d.x);\n"
+        "   half_width = 0.5*widths[gl_InstanceID];\n"
+        "   float extent = half_width + 1.0;\n"
+        "   vec2 p = (end == 0 ? p0 : p1) + n*(sides[corner]*extent);\n"
+        "   gl_Position = vec4(p/viewport*2.0 - 1.0, 0.0, 1.0);\n"
+        "   across = sides[corner]*extent;\n"
+        "   float value = shaded ? v[s + end] : 1.0;\n"
+        "   color = vec4(colors[gl_InstanceID].rgb*value, colors[gl_InstanceID].a);\n"
+        "}\n";
+
+    const char *fragShaderSrc =
+        "#version 460\n"
+        "layout(location = 0) out vec4 f_color;\n"
+        "in vec4 color;\n"
+        "in float across;\n"
+        "flat in float half_width;\n"
+        "void main()\n"
+        "{\n"
+        "   float coverage = clamp(half_width + 0.5 - abs(across), 0.0, 1.0);\n"
+        "   f_color = vec4(color.rgb*coverage, color.a);\n"
+        "}\n";
+
+    programObject = LoadProgram(vertShaderSrc, fragShaderSrc);
+    if (!programObject)
+    {
+        printf("ThickLine.cpp: Error, couldn't load program.\n");
+        return;
+    }
+
+    projectionLocation = glGetUniformLocation(programObject, "projection");
+    viewportLocation = glGetUniformLocation(programObject, "viewport");
+    widthsLocation = glGetUniformLocation(programObject, "widths");
+    colorsLocation = glGetUniformLocation(programObject, "colors");
+    shadedLocation = glGetUniformLocation(programObject, "shaded");
+}
+
+void ThickLine::ProgramDestroy(void)
+{
+    glDeleteProgram(programObject);
+}
+
+ThickLine::ThickLine(void)
+{
+    ProgramLoad();
+    glGenVertexArrays(1, &VAO);
+}
+
+ThickLine::~ThickLine(void)
+{
+    ProgramDestroy();
+    glDeleteVertexArrays(1, &VAO);
+}
+
+void ThickLine::Draw(const glm::mat4 &projection,
+                     GLuint x_buffer, GLintptr x_offset,
+                     GLuint y_buffer, GLintptr y_offset,
+                     GLuint v_buffer, GLintptr v_offset,
+                     int N, const glm::vec4 colors[2], const float widths[2])
+{
+    if(N < 2)
+        return;
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    GLsizeiptr bytes = sizeof(float)*N;
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, THICK_LINE_X_BINDING,
+                      x_buffer, x_offset, bytes);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, THICK_LINE_Y_BINDING,
+                      y_buffer, y_offset, bytes);
+    // the shader doesn't read v unshaded, but the binding must be valid
+    if(v_buffer)
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, THICK_LINE_V_BINDING,
+                          v_buffer, v_offset, bytes);
+    else
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, THICK_LINE_V_BINDING,
+                          y_buffer, y_offset, bytes);
+
+    glUseProgram(programObject);
+    glBindVertexArray(VAO);
+
+    glUniformMatrix4fv(projectionLocation, 1, GL_FALSE, glm::value_ptr(projection));
+    glUniform2f(viewportLocation, (float)viewport[2], (float)viewport[3]);
+    glUniform1fv(widthsLocation, 2, widths);
+    glUniform4fv(colorsLocation, 2, glm::value_ptr(colors[0]));
+    glUniform1i(shadedLocation, v_buffer ? 1 : 0);
+
+    // the glow and then the core, added on with the caller's blend
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6*(N-1), 2);
+
+    glBindVertexArray(0);
+    glUseProgram(0);
+}
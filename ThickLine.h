@@ -0,0 +1,73 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+/*
+  ==============================================================================
+
+    ThickLine.h
+
+    Wide, anti-aliased line strips for the core profile, where
+    glLineWidth above 1 is not required to work. The points are read
+    from shader storage buffers and each segment is expanded to a
+    screen space quad in the vertex shader from gl_VertexID, so no
+    vertex data is built on the CPU. The glow and the core of a trace
+    are the two instances of one draw; the fragment shader fades the
+    last pixel of each side from the distance to the centre line.
+
+    The quads end at the points, like wide GL lines, so the draw adds
+    the glow and then the core with the caller's blend as the two line
+    strips did.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+#define THICK_LINE_X_BINDING 0
+#define THICK_LINE_Y_BINDING 1
+#define THICK_LINE_V_BINDING 2
+
+class ThickLine
+{
+    GLuint programObject;
+    GLint  projectionLocation;
+    GLint  viewportLocation;
+    GLint  widthsLocation;
+    GLint  colorsLocation;
+    GLint  shadedLocation;
+    // no attributes, but the core profile draws with a VAO bound
+    GLuint VAO;
+
+    void ProgramLoad(void);
+    void ProgramDestroy(void);
+
+public:
+    ThickLine(void);
+    ~ThickLine(void);
+    // N points, floats at the byte offsets of each buffer. With a zero
+    // v_buffer the strip is unshaded. colors and widths are the glow
+    // and the core, widths in pixels.
+    void Draw(const glm::mat4 &projection,
+              GLuint x_buffer, GLintptr x_offset,
+              GLuint y_buffer, GLintptr y_offset,
+              GLuint v_buffer, GLintptr v_offset,
+              int N, const glm::vec4 colors[2], const float widths[2]);
+};
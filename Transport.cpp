@@ -0,0 +1,307 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+/*
+  ==============================================================================
+
+    Transport.cpp
+
+  ==============================================================================
+*/
+
+#include "Transport.h"
+#include <math.h>
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+TransportFormat Transport::Validate(int format)
+{
+    if(format < 0 || format >= TRANSPORT_NFORMATS)
+        return TRANSPORT_DEFAULT;
+    return (TransportFormat)format;
+}
+
+const char* Transport::Name(TransportFormat format)
+{
+    switch(format){
+    case TRANSPORT_FLOAT32: return "float32";
+    case TRANSPORT_FLOAT16: return "float16";
+    case TRANSPORT_INT16:   return "int16";
+    default:                return "unknown";
+    }
+}
+
+size_t Transport::SampleSize(TransportFormat format)
+{
+    return format==TRANSPORT_FLOAT32 ? sizeof(float) : sizeof(uint16_t);
+}
+
+/*
+    Scalar IEEE half conversions, round to nearest even. Used for the
+    tails and where no hardware conversion is available.
+*/
+static uint16_t float_to_half(float f)
+{
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    uint32_t sign = (x >> 16) & 0x8000;
+    uint32_t abs = x & 0x7fffffff;
+    if(abs >= 0x7f800000){
+        // inf or nan
+        return sign | 0x7c00 | (abs > 0x7f800000 ? 0x200 : 0);
+    }
+    if(abs >= 0x477ff000){
+        // overflows to inf
+        return sign | 0x7c00;
+    }
+    if(abs < 0x38800000){
+        // subnormal or zero
+        if(abs < 0x33000000)
+            return sign;
+        uint32_t m = (abs & 0x7fffff) | 0x800000;
+        int shift = 126 - (abs >> 23);
+        uint32_t h = m >> shift;
+        uint32_t rem = m & ((1u << shift) - 1);
+        uint32_t half = 1u << (shift - 1);
+        if(rem > half || (rem==half && (h & 1)))
+            h++;
+        return sign | h;
+    }
+    uint32_t h = ((abs - 0x38000000) >> 13);
+    uint32_t rem = abs & 0x1fff;
+    if(rem > 0x1000 || (rem==0x1000 && (h & 1)))
+        h++;
+    return sign | h;
+}
+
+static float half_to_float(uint16_t h)
+{
+    uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+    uint32_t exp = (h >> 10) & 0x1f;
+    uint32_t m = h & 0x3ff;
+    uint32_t x;
+    if(exp==0){
+        if(m==0){
+            x = sign;
+        }else{
+            // subnormal, normalise
+            exp = 113;
+            while(!(m & 0x400)){
+                m <<= 1;
+                exp--;
+            }
+            x = sign | (exp << 23) | ((m & 0x3ff) << 13);
+        }
+    }else if(exp==31){
+        x = sign | 0x7f800000 | (m << 13);
+    }else{
+        x = sign | ((exp + 112) << 23) | (m << 13);
+    }
+    float f;
+    memcpy(&f, &x, sizeof(f));
+    return f;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("f16c")))
+static size_t encode_half_f16c(const float *x, size_t n, uint16_t *dst)
+{
+    size_t i = 0;
+    for(;i+8<=n;i+=8){
+        __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(x + i),
+            _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i*)(dst + i), h);
+    }
+    return i;
+}
+
+__attribute__((target("f16c")))
+static size_t decode_half_f16c(const uint16_t *src, size_t n, float *x)
+{
+    size_t i = 0;
+    for(;i+8<=n;i+=8){
+        __m128i h = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm256_storeu_ps(x + i, _mm256_cvtph_ps(h));
+    }
+    return i;
+}
+
+static bool have_f16c(void)
+{
+    static const bool f16c = __builtin_cpu_supports("f16c");
+    return f16c;
+}
+#endif
+
+static void encode_half(const float *x, size_t n, uint16_t *dst)
+{
+    size_t i = 0;
+#if defined(__x86_64__) || defined(__i386__)
+    if(have_f16c())
+        i = encode_half_f16c(x, n, dst);
+#elif defined(__aarch64__)
+    for(;i+4<=n;i+=4){
+        float16x4_t h = vcvt_f16_f32(vld1q_f32(x + i));
+        vst1_u16(dst + i, vreinterpret_u16_f16(h));
+    }
+#endif
+    for(;i<n;i++)
+        dst[i] = float_to_half(x[i]);
+}
+
+static void decode_half(const uint16_t *src, size_t n, float *x)
+{
+    size_t i = 0;
+#if defined(__x86_64__) || defined(__i386__)
+    if(have_f16c())
+        i = decode_half_f16c(src, n, x);
+#elif defined(__aarch64__)
+    for(;i+4<=n;i+=4){
+        float16x4_t h = vreinterpret_f16_u16(vld1_u16(src + i));
+        vst1q_f32(x + i, vcvt_f32_f16(h));
+    }
+#endif
+    for(;i<n;i++)
+        x[i] = half_to_float(src[i]);
+}
+
+static float max_abs(const float *x, size_t n)
+{
+    size_t i = 0;
+    float m = 0.0f;
+#if defined(__SSE2__)
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 vm = _mm_setzero_ps();
+    for(;i+4<=n;i+=4){
+        vm = _mm_max_ps(vm, _mm_and_ps(_mm_loadu_ps(x + i), abs_mask));
+    }
+    float t[4];
+    _mm_storeu_ps(t, vm);
+    m = fmaxf(fmaxf(t[0], t[1]), fmaxf(t[2], t[3]));
+#elif defined(__aarch64__)
+    float32x4_t vm = vdupq_n_f32(0.0f);
+    for(;i+4<=n;i+=4){
+        vm = vmaxq_f32(vm, vabsq_f32(vld1q_f32(x + i)));
+    }
+    m = vmaxvq_f32(vm);
+#endif
+    for(;i<n;i++){
+        float a = fabsf(x[i]);
+        if(a > m) m = a;
+    }
+    return m;
+}
+
+static int16_t saturate_int16(float v)
+{
+    if(isnan(v)) return 0;
+    v = rintf(v);
+    if(v > 32767.0f) return 32767;
+    if(v < -32768.0f) return -32768;
+    return (int16_t)v;
+}
+
+static int encode_int16(const float *x, size_t n, uint16_t *dst)
+{
+    // the smallest exponent with max|x| < 2^exponent
+    int exponent = 0;
+    float m = max_abs(x, n);
+    if(m > 0.0f && isfinite(m))
+        frexpf(m, &exponent);
+    float scale = ldexpf(1.0f, 15 - exponent);
+
+    size_t i = 0;
+    int16_t *q = (int16_t*)dst;
+#if defined(__SSE2__)
+    // cvtps gives INT_MIN for +inf and nan, so clamp in float first
+    // and zero the nans, as saturate_int16 does
+    const __m128 vs = _mm_set1_ps(scale);
+    const __m128 lo = _mm_set1_ps(-32768.0f);
+    const __m128 hi = _mm_set1_ps(32767.0f);
+    for(;i+8<=n;i+=8){
+        __m128 va = _mm_mul_ps(_mm_loadu_ps(x + i), vs);
+        __m128 vb = _mm_mul_ps(_mm_loadu_ps(x + i + 4), vs);
+        va = _mm_and_ps(_mm_min_ps(_mm_max_ps(va, lo), hi), _mm_cmpord_ps(va, va));
+        vb = _mm_and_ps(_mm_min_ps(_mm_max_ps(vb, lo), hi), _mm_cmpord_ps(vb, vb));
+        __m128i a = _mm_cvtps_epi32(va);
+        __m128i b = _mm_cvtps_epi32(vb);
+        _mm_storeu_si128((__m128i*)(q + i), _mm_packs_epi32(a, b));
+    }
+#elif defined(__aarch64__)
+    const float32x4_t vs = vdupq_n_f32(scale);
+    for(;i+8<=n;i+=8){
+        int32x4_t a = vcvtnq_s32_f32(vmulq_f32(vld1q_f32(x + i), vs));
+        int32x4_t b = vcvtnq_s32_f32(vmulq_f32(vld1q_f32(x + i + 4), vs));
+        vst1q_s16(q + i, vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+    }
+#endif
+    for(;i<n;i++)
+        q[i] = saturate_int16(x[i]*scale);
+    return exponent;
+}
+
+static void decode_int16(const uint16_t *src, size_t n, int exponent, float *x)
+{
+    float scale = ldexpf(1.0f, exponent - 15);
+    const int16_t *q = (const int16_t*)src;
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128 vs = _mm_set1_ps(scale);
+    for(;i+8<=n;i+=8){
+        __m128i v = _mm_loadu_si128((const __m128i*)(q + i));
+        // sign extend by unpacking into the high half and shifting down
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(x + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), vs));
+        _mm_storeu_ps(x + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), vs));
+    }
+#elif defined(__aarch64__)
+    const float32x4_t vs = vdupq_n_f32(scale);
+    for(;i+8<=n;i+=8){
+        int16x8_t v = vld1q_s16(q + i);
+        float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(v)));
+        float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(v)));
+        vst1q_f32(x + i, vmulq_f32(lo, vs));
+        vst1q_f32(x + i + 4, vmulq_f32(hi, vs));
+    }
+#endif
+    for(;i<n;i++)
+        x[i] = q[i]*scale;
+}
+
+int Transport::Encode(TransportFormat format, const float *x, size_t n, uint16_t *dst)
+{
+    if(format==TRANSPORT_FLOAT16){
+        encode_half(x, n, dst);
+        return 0;
+    }
+    return encode_int16(x, n, dst);
+}
+
+void Transport::Decode(TransportFormat format, const uint16_t *src, size_t n, int exponent, float *x)
+{
+    if(format==TRANSPORT_FLOAT16){
+        decode_half(src, n, x);
+    }else{
+        decode_int16(src, n, exponent, x);
+    }
+}
@@ -0,0 +1,62 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+/*
+  ==============================================================================
+
+    Transport.h
+
+    Sample formats for the RawAudio stream from the plugin to the UI.
+    float16 and int16 halve the atom traffic. int16 uses one block
+    exponent per chunk so that quiet signals keep their resolution.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+enum TransportFormat
+{
+    TRANSPORT_FLOAT32 = 0,
+    TRANSPORT_FLOAT16,
+    TRANSPORT_INT16,
+    TRANSPORT_NFORMATS
+};
+
+#define TRANSPORT_DEFAULT TRANSPORT_FLOAT32
+
+// largest RawAudio chunk, in stereo frames
+#define RAW_CHUNK_FRAMES 2048
+
+class Transport
+{
+public:
+    static TransportFormat Validate(int format);
+    static const char* Name(TransportFormat format);
+    // bytes per sample on the wire
+    static size_t SampleSize(TransportFormat format);
+
+    // Convert n float samples to float16 or int16 in dst. Returns the
+    // block exponent for int16: sample = q * 2^(exponent-15).
+    static int Encode(TransportFormat format, const float *x, size_t n, uint16_t *dst);
+    // inverse of Encode
+    static void Decode(TransportFormat format, const uint16_t *src, size_t n, int exponent, float *x);
+};
@@ -0,0 +1,305 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  ==============================================================================
+
+    Trigger.cpp
+
+  ==============================================================================
+*/
+
+#include "Trigger.h"
+#include <math.h>
+#include <string.h>
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/*
+    Index of the first of the n values of x at or above threshold, or
+    below it, n if there is none.
+*/
+static int find_first(const float *x, int n, float threshold, bool above)
+{
+    int i = 0;
+#if defined(__SSE__)
+    __m128 t = _mm_set1_ps(threshold);
+    for(;i+4<=n;i+=4){
+        __m128 v = _mm_loadu_ps(x + i);
+        int m = _mm_movemask_ps(above ? _mm_cmpge_ps(v, t) : _mm_cmplt_ps(v, t));
+        if(m)
+            return i + __builtin_ctz(m);
+    }
+#elif defined(__ARM_NEON)
+    float32x4_t t = vdupq_n_f32(threshold);
+    for(;i+4<=n;i+=4){
+        float32x4_t v = vld1q_f32(x + i);
+        uint32x4_t m = above ? vcgeq_f32(v, t) : vcltq_f32(v, t);
+        uint32x2_t r = vorr_u32(vget_low_u32(m), vget_high_u32(m));
+        if(vget_lane_u32(vpmax_u32(r, r), 0))
+            break;
+    }
+#endif
+    for(;i<n;i++){
+        if(above ? x[i] >= threshold : x[i] < threshold)
+            return i;
+    }
+    return n;
+}
+
+Trigger::Trigger(int nChannels, double fs)
+    :nChannels(nChannels),
+    fs(fs),
+    written(0),
+    capture_count(0)
+{
+    Nholdoff = 0;
+    Allocate();
+    Reset();
+}
+
+Trigger::~Trigger(void)
+{
+}
+
+void Trigger::Allocate(void)
+{
+    Nwindow = (int)lround(settings.time*fs);
+    if(Nwindow < TRIGGER_WINDOW_MIN)
+        Nwindow = TRIGGER_WINDOW_MIN;
+    Npre = (int)(settings.position*Nwindow);
+    Nauto = (uint64_t)(TRIGGER_AUTO_TIMEOUT*fs);
+    if(Nauto < (uint64_t)Nwindow)
+        Nauto = Nwindow;
+    // a window is complete at most a chunk after it is appended
+    Nring = 1;
+    while(Nring < Nwindow + TRIGGER_CHUNK)
+        Nring <<= 1;
+    ring.reset(new float[(size_t)Nring*nChannels]());
+    capture.reset(new float[(size_t)Nwindow*nChannels]);
+    captured = false;
+    capture_count++;
+    written = 0;
+}
+
+void Trigger::Reset(void)
+{
+    armed = false;
+    pending = false;
+    stopped = false;
+    scan_from = written;
+    last_capture = written;
+}
+
+void Trigger::Set(const TriggerSettings &s)
+{
+    TriggerSettings last = settings;
+    settings = s;
+    settings.mode = Validate(s.mode);
+    if(settings.edge!=TRIGGER_FALLING) settings.edge = TRIGGER_RISING;
+    if(!(settings.time >= TRIGGER_TIME_MIN)) settings.time = TRIGGER_TIME_MIN;
+    if(settings.time > TRIGGER_TIME_MAX) settings.time = TRIGGER_TIME_MAX;
+    if(!(settings.position >= 0.0f)) settings.position = 0.0f;
+    if(settings.position > 1.0f) settings.position = 1.0f;
+    if(!(settings.hysteresis >= 0.0f)) settings.hysteresis = 0.0f;
+    if(!(settings.holdoff >= 0.0)) settings.holdoff = 0.0;
+    Nholdoff = (uint64_t)(settings.holdoff*fs);
+
+    bool resize = settings.time!=last.time || settings.position!=last.position;
+    if(resize)
+        Allocate();
+    if(resize || settings.mode!=last.mode || settings.edge!=last.edge)
+        Reset();
+}
+
+void Trigger::Rearm(void)
+{
+    Reset();
+}
+
+const float* Trigger::GetCapture(int &N)
+{
+    N = Nwindow;
+    return captured ? capture.get() : nullptr;
+}
+
+/*
+    First sample of channel 0 from p to e-1 at or above threshold, or
+    below it, e if there is none.
+*/
+uint64_t Trigger::Find(uint64_t p, uint64_t e, float threshold, bool above)
+{
+    while(p < e){
+        int i0 = (int)(p & (Nring-1));
+        int n = Nring - i0;
+        if((uint64_t)n > e - p) n = (int)(e - p);
+        int k = find_first(&ring[i0], n, threshold, above);
+        if(k < n)
+            return p + k;
+        p += n;
+    }
+    return e;
+}
+
+/*
+    Search the samples s to e-1 for triggers. For a rising edge the
+    signal has to go below level-hysteresis to arm and then reach
+    level to trigger, a falling edge is the mirror image.
+*/
+void Trigger::Scan(uint64_t s, uint64_t e)
+{
+    bool rising = settings.edge==TRIGGER_RISING;
+    float level = settings.level;
+    float arm_level = rising ? level - settings.hysteresis
+                             : level + settings.hysteresis;
+    uint64_t p = s > scan_from ? s : scan_from;
+    // a trigger needs the samples before it in the ring
+    if(p < (uint64_t)Npre)
+        p = Npre;
+    while(p < e && !pending && !stopped){
+        if(!armed){
+            p = Find(p, e, arm_level, !rising);
+            if(p==e)
+                break;
+            armed = true;
+        }
+        uint64_t i = Find(p, e, level, rising);
+        if(i==e)
+            break;
+        armed = false;
+        pending = true;
+        trigger_at = i;
+        uint64_t end = i - Npre + Nwindow;
+        scan_from = end > i + Nholdoff ? end : i + Nholdoff;
+        p = scan_from;
+        Complete(e);
+    }
+}
+
+/*
+    Capture the pending window once the samples up to e hold it.
+*/
+bool Trigger::Complete(uint64_t e)
+{
+    if(!pending)
+        return false;
+    uint64_t start = trigger_at - Npre;
+    if(e < start + Nwindow)
+        return false;
+    Capture(start);
+    pending = false;
+    last_capture = e;
+    if(settings.mode==TRIGGER_SINGLE)
+        stopped = true;
+    return true;
+}
+
+void Trigger::Capture(uint64_t start)
+{
+    int i0 = (int)(start & (Nring-1));
+    int n1 = Nring - i0;
+    if(n1 > Nwindow) n1 = Nwindow;
+    for(int c=0;c<nChannels;c++){
+        const float *r = &ring[(size_t)c*Nring];
+        float *dst = &capture[(size_t)c*Nwindow];
+        memcpy(dst, r + i0, sizeof(float)*n1);
+        memcpy(dst + n1, r, sizeof(float)*(Nwindow - n1));
+    }
+    captured = true;
+    capture_count++;
+}
+
+void Trigger::Process(const float *x, int stride, int n)
+{
+    while(n > 0){
+        int m = n < TRIGGER_CHUNK ? n : TRIGGER_CHUNK;
+        int i0 = (int)(written & (Nring-1));
+        int m1 = Nring - i0;
+        if(m1 > m) m1 = m;
+        for(int c=0;c<nChannels;c++){
+            float *r = &ring[(size_t)c*Nring];
+            memcpy(r + i0, x + c*stride, sizeof(float)*m1);
+            memcpy(r, x + c*stride + m1, sizeof(float)*(m - m1));
+        }
+        uint64_t s = written;
+        written += m;
+
+        Complete(written);
+        Scan(s, written);
+        if(settings.mode==TRIGGER_AUTO && !pending
+            && written - last_capture >= Nauto){
+            // nothing triggered lately, show the latest window
+            Capture(written >= (uint64_t)Nwindow ? written - Nwindow : 0);
+            last_capture = written;
+        }
+        x += m;
+        n -= m;
+    }
+}
+
+TriggerMode Trigger::Validate(int mode)
+{
+    if(mode < 0 || mode >= TRIGGER_NMODES)
+        return TRIGGER_OFF;
+    return (TriggerMode)mode;
+}
+
+const char* Trigger::Name(TriggerMode mode)
+{
+    switch(mode){
+    case TRIGGER_OFF:    return "off";
+    case TRIGGER_AUTO:   return "auto";
+    case TRIGGER_NORMAL: return "normal";
+    case TRIGGER_SINGLE: return "single";
+    default:             return "unknown";
+    }
+}
+
+const char* Trigger::EdgeName(TriggerEdge edge)
+{
+    return edge==TRIGGER_FALLING ? "falling" : "rising";
+}
+
+double Trigger::StepTime(double time, int dir)
+{
+    static const double steps[3] = {1.0, 2.0, 5.0};
+    double decade = pow(10.0, floor(log10(time) + 1e-9));
+    int k = 0;
+    while(k < 3 && time > steps[k]*decade*(1.0 + 1e-6))
+        k++;
+    if(k==3){
+        k = 0;
+        decade *= 10.0;
+    }
+    k += dir;
+    if(k < 0){
+        k = 2;
+        decade /= 10.0;
+    }else if(k > 2){
+        k = 0;
+        decade *= 10.0;
+    }
+    double t = steps[k]*decade;
+    if(t < TRIGGER_TIME_MIN) t = TRIGGER_TIME_MIN;
+    if(t > TRIGGER_TIME_MAX) t = TRIGGER_TIME_MAX;
+    return t;
+}
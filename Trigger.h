@@ -0,0 +1,147 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  ==============================================================================
+
+    Trigger.h
+
+    Oscilloscope trigger for the time view. The samples are kept in a
+    ring as they arrive and channel 0 is searched for an edge through
+    level, with hysteresis so that noise around the level doesn't
+    retrigger. The search alternates between looking for the arming
+    side of the level and for the crossing, each a vectorised scan, so
+    it costs O(block) where the samples come in and nothing per frame
+    where they are drawn.
+
+    When a window of the chosen length around a trigger is complete it
+    is copied out, channel-major, and held until the next one:
+        auto    triggers when it can, otherwise shows the latest window
+                after TRIGGER_AUTO_TIMEOUT
+        normal  only triggered windows
+        single  the first triggered window, until rearmed
+    Holdoff ignores triggers for a time after each one.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+
+enum TriggerMode
+{
+    TRIGGER_OFF = 0,
+    TRIGGER_AUTO,
+    TRIGGER_NORMAL,
+    TRIGGER_SINGLE,
+    TRIGGER_NMODES
+};
+
+enum TriggerEdge
+{
+    TRIGGER_RISING = 0,
+    TRIGGER_FALLING,
+    TRIGGER_NEDGES
+};
+
+// window length limits in seconds
+#define TRIGGER_TIME_MIN     20e-6
+#define TRIGGER_TIME_MAX     1.0
+#define TRIGGER_TIME_DEFAULT 0.01
+// fewest samples in a window
+#define TRIGGER_WINDOW_MIN   4
+// free running interval of auto mode, in seconds
+#define TRIGGER_AUTO_TIMEOUT 0.1
+// samples appended and searched at a time
+#define TRIGGER_CHUNK        4096
+
+struct TriggerSettings
+{
+    TriggerMode mode = TRIGGER_OFF;
+    TriggerEdge edge = TRIGGER_RISING;
+    float level = 0.0f;
+    float hysteresis = 0.01f;
+    // seconds
+    double holdoff = 0.0;
+    double time = TRIGGER_TIME_DEFAULT;
+    // part of the window before the trigger
+    float position = 0.25f;
+};
+
+class Trigger
+{
+    int nChannels;
+    double fs;
+    TriggerSettings settings;
+    int Nwindow;
+    int Npre;
+    uint64_t Nholdoff;
+    uint64_t Nauto;
+
+    // channel-major ring of Nring samples per channel, a power of two
+    // holding a window and a chunk
+    int Nring;
+    std::unique_ptr<float[]> ring;
+    uint64_t written;
+
+    bool armed;
+    bool pending;
+    bool stopped;
+    uint64_t trigger_at;
+    uint64_t scan_from;
+    uint64_t last_capture;
+
+    std::unique_ptr<float[]> capture;
+    bool captured;
+    // bumped by each capture and by each reallocation
+    uint64_t capture_count;
+
+    void Allocate(void);
+    void Reset(void);
+    uint64_t Find(uint64_t p, uint64_t e, float threshold, bool above);
+    void Scan(uint64_t s, uint64_t e);
+    bool Complete(uint64_t e);
+    void Capture(uint64_t start);
+
+public:
+    Trigger(int nChannels, double fs);
+    ~Trigger(void);
+
+    // append n samples of each channel, channel c at x + c*stride
+    void Process(const float *x, int stride, int n);
+    void Set(const TriggerSettings &settings);
+    // arm single mode again
+    void Rearm(void);
+
+    // The capture is written by Process and replaced by Set, the caller
+    // excludes both while reading it or the mode.
+    TriggerMode GetMode(void) { return settings.mode; }
+    // the last captured window, Nwindow samples per channel, or null
+    const float* GetCapture(int &N);
+    // changes whenever GetCapture would return something new
+    uint64_t GetCaptureCount(void) { return capture_count; }
+
+    static TriggerMode Validate(int mode);
+    static const char* Name(TriggerMode mode);
+    static const char* EdgeName(TriggerEdge edge);
+    // the next window length in a 1-2-5 sequence, dir +1 or -1
+    static double StepTime(double time, int dir);
+};
@@ -29,12 +29,14 @@
 
 #include "Waterfall.h"
 #include "Shader.h"
+#include "Transport.h"
 #include <math.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/transform.hpp>
 #include <iostream>
+#include <string.h>
 
 #define X_VERTEX_LOC 0
 #define Y_VERTEX_LOC 1
@@ -59,13 +61,23 @@ void Waterfall::InitQuads(void)
         "#version 460\n"
         "in vec2 tex;\n"
         "layout(location =0) out vec4 outColor;\n"
-        "uniform sampler2D s_texture;\n"
-        "uniform vec4 color_l;\n"
-        "uniform vec4 color_r;\n"
+        "uniform sampler2DArray s_texture;\n"
+        "uniform vec4 colors[8];\n"
+        "uniform int n_channels;\n"
+        "uniform float dB_min;\n"
+        "uniform float dB_scale;\n"
+        "uniform float head;\n"
+        "uniform float span;\n"
         "void main(void)\n"
         "{\n"
-        "   vec4 t = texture(s_texture, tex);\n"
-        "   outColor = vec4((color_l.rgb*t.r + color_r.rgb*t.g), 1.0);\n"
+        "   // tex.y runs from the newest line at the top to the oldest shown\n"
+        "   vec2 t = vec2(tex.x, fract(head - tex.y*span));\n"
+        "   vec3 c = vec3(0.0);\n"
+        "   for(int l=0;l<n_channels;l++){\n"
+        "       float dB = texture(s_texture, vec3(t, l)).r;\n"
+        "       c += colors[l].rgb*clamp((dB - dB_min)*dB_scale, 0.0, 1.0);\n"
+        "   }\n"
+        "   outColor = vec4(c, 1.0);\n"
         "}\n";
 
     program = LoadProgram(vShaderSrc, fShaderSrc);
@@ -75,59 +87,28 @@ void Waterfall::InitQuads(void)
 
     mvp_loc = glGetUniformLocation(program, "mvp");
     s_texture_loc = glGetUniformLocation(program, "s_texture");
-    color_l_loc = glGetUniformLocation(program, "color_l");
-    color_r_loc = glGetUniformLocation(program, "color_r");
-
-    Attributes attributes1[4] =
-        {
-            {glm::vec2( 0.0, 0.0),glm::vec2(0.0,1.0)},
-            {glm::vec2( 1.0, 0.0),glm::vec2(1.0,1.0)},
-            {glm::vec2( 0.0, 1.0),glm::vec2(0.0,0.0)},
-            {glm::vec2( 1.0, 1.0),glm::vec2(1.0,0.0)}
-        };
-
-    Attributes attributes2[4] =
-        {
-            {glm::vec2( 0.0,-1.0),glm::vec2(0.0,1.0)},
-            {glm::vec2( 1.0,-1.0),glm::vec2(1.0,1.0)},
-            {glm::vec2( 0.0, 0.0),glm::vec2(0.0,0.0)},
-            {glm::vec2( 1.0, 0.0),glm::vec2(1.0,0.0)}
-        };
-
-
+    colors_loc = glGetUniformLocation(program, "colors");
+    n_channels_loc = glGetUniformLocation(program, "n_channels");
+    dB_min_loc = glGetUniformLocation(program, "dB_min");
+    dB_scale_loc = glGetUniformLocation(program, "dB_scale");
+    head_loc = glGetUniformLocation(program, "head");
+    span_loc = glGetUniformLocation(program, "span");
+
+    // filled by InitializeBuffers once the columns are known
     glGenBuffers(1, &x_vbo);
     glGenBuffers(1, &tex_vbo);
-    glGenBuffers(2, y_vbos);
-    glGenVertexArrays(2, vaos);
-
-    InitializeBuffers();
-    InitializeFrequency();
+    glGenBuffers(1, &y_vbo);
+    glGenVertexArrays(1, &vao);
     
     //
-    // the vertex array object for the upper quad
+    // the vertex array object for the quad
     //
-    glBindVertexArray(vaos[0]);
+    glBindVertexArray(vao);
     glBindBuffer(GL_ARRAY_BUFFER, x_vbo);
     glVertexAttribPointer(X_VERTEX_LOC, 1, GL_FLOAT, GL_FALSE, 0, NULL);
     glEnableVertexAttribArray(X_VERTEX_LOC);
     
-    glBindBuffer(GL_ARRAY_BUFFER, y_vbos[0]);
-    glVertexAttribPointer(Y_VERTEX_LOC, 1, GL_FLOAT, GL_FALSE, 0, NULL);
-    glEnableVertexAttribArray(Y_VERTEX_LOC);
-    
-    glBindBuffer(GL_ARRAY_BUFFER, tex_vbo);
-    glVertexAttribPointer(TEXEL_LOC, 2, GL_FLOAT, GL_FALSE, 0, NULL);
-    glEnableVertexAttribArray(TEXEL_LOC);
-    
-    //
-    // the vertex array object for the lower quad
-    //
-    glBindVertexArray(vaos[1]);
-    glBindBuffer(GL_ARRAY_BUFFER, x_vbo);
-    glVertexAttribPointer(X_VERTEX_LOC, 1, GL_FLOAT, GL_FALSE, 0, NULL);
-    glEnableVertexAttribArray(X_VERTEX_LOC);
-    
-    glBindBuffer(GL_ARRAY_BUFFER, y_vbos[1]);
+    glBindBuffer(GL_ARRAY_BUFFER, y_vbo);
     glVertexAttribPointer(Y_VERTEX_LOC, 1, GL_FLOAT, GL_FALSE, 0, NULL);
     glEnableVertexAttribArray(Y_VERTEX_LOC);
     
@@ -138,25 +119,11 @@ void Waterfall::InitQuads(void)
     glBindVertexArray(0);
 
     
-    GLint tsize;
     glGetIntegerv(GL_MAX_TEXTURE_SIZE, &tsize);
-    if( Npoints > tsize ){
-        std::cout << "Maximum texture size exceeded." << std::endl;
-        return;
-    }
-    
-    glGenTextures(2, textures);
-    glActiveTexture(GL_TEXTURE0);
-    for(int t=0;t<2;t++){
-        glBindTexture(GL_TEXTURE_2D, textures[t]);
-        glTexStorage2D(GL_TEXTURE_2D, 1,
-                       GL_RG8, Npoints, Nlines);
-        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
-        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
-        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
-        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
-        glTexParameteri( GL_TEXTURE_2D, GL_AUTO_GENERATE_MIPMAP, GL_FALSE );
-    }
+    if( Nhistory > tsize )
+        Nhistory = tsize;
+    texture = 0;
+    Ntex = 0;
 
     quadsInitialized = true;
 
@@ -166,44 +133,86 @@ void Waterfall::DeleteQuads(void)
 {
     if(!quadsInitialized) return;
     glDeleteProgram(program);
-    glDeleteBuffers(2, y_vbos);
+    glDeleteBuffers(1, &y_vbo);
     glDeleteBuffers(1, &x_vbo);
     glDeleteBuffers(1, &tex_vbo);
-    glDeleteVertexArrays(2, vaos);
-    glDeleteTextures(2, textures);
+    glDeleteVertexArrays(1, &vao);
+    if(texture)
+        glDeleteTextures(1, &texture);
+    upload.reset(nullptr);
     quadsInitialized = false;
 }
 
+/*
+    A texture Ncols wide for the current columns, cleared, and an
+    upload buffer with room for it.
+*/
+void Waterfall::CreateTexture(void)
+{
+    if(texture){
+        glDeleteTextures(1, &texture);
+        texture = 0;
+        Ntex = 0;
+    }
+    if( Ncols > tsize ){
+        std::cout << "Maximum texture size exceeded." << std::endl;
+        return;
+    }
+
+    // the ring wraps in t, so the rows either side of the cursor filter
+    // into each other as they do anywhere else
+    glGenTextures(1, &texture);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1,
+                   GL_R16F, Ncols, Nhistory, Nchannels);
+    glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT );
+    glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+    glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+    // rows not yet written draw black at any limits
+    const float empty = WATERFALL_DB_EMPTY;
+    glClearTexImage(texture, 0, GL_RED, GL_FLOAT, &empty);
+    Ntex = Ncols;
+
+    if(Ncols > Nupload){
+        upload.reset(nullptr);
+        upload.reset(new StreamBuffer(sizeof(uint16_t)*Ncols*Nchannels
+                                      *upload_rows));
+        Nupload = Ncols;
+    }
+}
+
 void Waterfall::InitializeBuffers(void)
 {
     //
-    // y_vbo[0]; the top quad
+    // x_vbo; each column starts at its point
     //
-    glBindBuffer(GL_ARRAY_BUFFER, y_vbos[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float)*Npoints*2,
-                 NULL, GL_STATIC_DRAW);
-    float *ymap = (float*)glMapBufferRange(GL_ARRAY_BUFFER,
-                                           0, sizeof(float)*Npoints*2,
+    glBindBuffer(GL_ARRAY_BUFFER, x_vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(float)*Ncols*2,
+                 NULL, GL_DYNAMIC_DRAW);
+    float *xmap = (float*)glMapBufferRange(GL_ARRAY_BUFFER,
+                                           0, sizeof(float)*Ncols*2,
                                            GL_MAP_WRITE_BIT|
                                            GL_MAP_INVALIDATE_BUFFER_BIT);
-    for(int i=0;i<Npoints*2;i+=2){
-        ymap[i] = 1.0f;
-        ymap[i+1] = 0.0f;
+    for(int i=0,f=0;i<Ncols*2;i+=2,f++){
+        xmap[i] = column_x[f];
+        xmap[i+1] = column_x[f];
     }
 
     glUnmapBuffer(GL_ARRAY_BUFFER);
- 
+
     //
-    // y_vbos[1]; the bottom quad
+    // y_vbo; the quad covers the pane, top to bottom
     //
-    glBindBuffer(GL_ARRAY_BUFFER, y_vbos[1]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float)*Npoints*2,
-                 NULL, GL_STATIC_DRAW);
-    ymap = (float*)glMapBufferRange(GL_ARRAY_BUFFER,
-                                           0, sizeof(float)*Npoints*2,
+    glBindBuffer(GL_ARRAY_BUFFER, y_vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(float)*Ncols*2,
+                 NULL, GL_DYNAMIC_DRAW);
+    float *ymap = (float*)glMapBufferRange(GL_ARRAY_BUFFER,
+                                           0, sizeof(float)*Ncols*2,
                                            GL_MAP_WRITE_BIT|
                                            GL_MAP_INVALIDATE_BUFFER_BIT);
-    for(int i=0;i<Npoints*2;i+=2){
+    for(int i=0;i<Ncols*2;i+=2){
         ymap[i] = 0.0f;
         ymap[i+1] = -1.0f;
     }
@@ -211,17 +220,17 @@ void Waterfall::InitializeBuffers(void)
     glUnmapBuffer(GL_ARRAY_BUFFER);
  
     //
-    // tex_vbo
+    // tex_vbo; the centre of each texel column
     //
     glBindBuffer(GL_ARRAY_BUFFER, tex_vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec2)*Npoints*2,
-                 NULL, GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec2)*Ncols*2,
+                 NULL, GL_DYNAMIC_DRAW);
     glm::vec2* tex_map = (glm::vec2*)glMapBufferRange(GL_ARRAY_BUFFER,
-                                           0, sizeof(glm::vec2)*Npoints*2,
+                                           0, sizeof(glm::vec2)*Ncols*2,
                                            GL_MAP_WRITE_BIT|
                                            GL_MAP_INVALIDATE_BUFFER_BIT);
-    for(int i=0,f=0;i<Npoints*2;i+=2,f++){
-        float alpha = (float)f/(Npoints-1);
+    for(int i=0,f=0;i<Ncols*2;i+=2,f++){
+        float alpha = (f + 0.5f)/Ncols;
         tex_map[i].x = alpha;
         tex_map[i].y = 0.0f;
         tex_map[i+1].x = alpha;
@@ -231,65 +240,53 @@ void Waterfall::InitializeBuffers(void)
     glUnmapBuffer(GL_ARRAY_BUFFER);
 }
 
-void Waterfall::InitializeFrequency(bool log)
-{
-    glBindBuffer(GL_ARRAY_BUFFER, x_vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float)*Npoints*2,
-                 NULL, GL_DYNAMIC_DRAW);
-    float *xmap = (float*)glMapBufferRange(GL_ARRAY_BUFFER,
-                                           0, sizeof(float)*Npoints*2,
-                                           GL_MAP_WRITE_BIT|
-                                           GL_MAP_INVALIDATE_BUFFER_BIT);
-                                           
-    if(!log){
-        for(int i=0,f=0;i<Npoints*2;i+=2,f++){
-            float alpha = (float)f/(Npoints-1);
-            xmap[i] = alpha;
-            xmap[i+1] = alpha;
-        }
-    }else{
-        float alpha2 = logf(2.0f)/logf((float)Npoints);
-        float beta = alpha2/(1.0f + alpha2);
-        float one_m_beta = 1.0f - beta;
-
-        xmap[0] = 0.0f;
-        xmap[1] = 0.0f;
-        
-        for(int i=2,n=1;i<Npoints*2;i+=2,n++){
-            float alpha = logf((float)n) / logf((float)Npoints);
-            float x = beta + alpha*one_m_beta;
-            xmap[i] = x;
-            xmap[i+1] = x;
-        }
-    }
-
-    glUnmapBuffer(GL_ARRAY_BUFFER);
-}
-
 
 Waterfall::Waterfall(
     int Npoints,
+    int Nchannels,
     int Nlines,
+    float history,
     float line_rate,
     float frame_rate) :
+    quadsInitialized(false),
     Npoints(Npoints),
+    Nchannels(Nchannels),
     Nlines(Nlines)
 {
+    if(Waterfall::Nchannels > WATERFALL_MAX_CHANNELS)
+        Waterfall::Nchannels = WATERFALL_MAX_CHANNELS;
+    // at least a screen, at most the memory budget
+    size_t row_bytes = sizeof(uint16_t)*Npoints*Waterfall::Nchannels;
+    double rows = ceil((double)history*line_rate);
+    double rows_max = (double)(WATERFALL_MEMORY_MAX/row_bytes);
+    if(rows > rows_max) rows = rows_max;
+    if(rows < Nlines) rows = Nlines;
+    Nhistory = (int)rows;
     InitQuads();
     if(!quadsInitialized) return;
-    line = Nlines;
-    draw_line = 1.0f;
+    line = 0;
+    filled = 0;
+    stale = 0;
+    draw_line = 0.0f;
     lines_per_frame = line_rate/frame_rate;
     threshold = ceilf(lines_per_frame);
     //std::cout << "lines_per_frame:" << lines_per_frame << std::endl;
-    texture_phase = true;
-    current_tex = textures[0];
-    trailing_tex = textures[1];
+    paused = false;
+    scroll = 0;
+    // two frames' worth, a longer burst waits for the GPU in Allocate
+    upload_rows = 2*(int)threshold;
+    if(upload_rows < WATERFALL_UPLOAD_ROWS) upload_rows = WATERFALL_UPLOAD_ROWS;
+    if(upload_rows > Nhistory) upload_rows = Nhistory;
+    Nupload = 0;
+    Ncols = 0;
+    Ncols_max = 0;
+    columns_dirty = false;
+    lines.reset(new uint16_t[(size_t)Nhistory*Waterfall::Nchannels*Npoints]);
+    decoded.reset(new float[Waterfall::Nchannels*Npoints]);
     view_width = 1.0;
     view_height = 1.0;
     dB_min = -180.0;
     dB_max = 0.0;
-    pixels.reset(new wPixel[Npoints]);
 }
 
 Waterfall::~Waterfall()
@@ -313,55 +310,186 @@ void Waterfall::SetdBLimits(float dB_min, float dB_max)
     Waterfall::dB_max = dB_max;
 }
 
-unsigned char Waterfall::dB2intensity(float dB_x)
+void Waterfall::SetColumns(const PointSpan *map, const float *x, int n)
 {
-    float intensity;
-    if(dB_x >= dB_max){
-        intensity = 1.0f;
-    }else if(dB_x <= dB_min){
-        intensity = 0.0f;
-    }else{
-        intensity = (dB_x - dB_min)/(dB_max - dB_min);
+    if(!quadsInitialized) return;
+    if(n > Ncols_max){
+        columns.reset(new PointSpan[n]);
+        column_x.reset(new float[n]);
+        pooled.reset(new float[n]);
+        Ncols_max = n;
     }
-    //intensity*=intensity;
-    unsigned char c = intensity*255.0f;
-    return c;
+    memcpy(columns.get(), map, sizeof(PointSpan)*n);
+    memcpy(column_x.get(), x, sizeof(float)*n);
+    Ncols = n;
+    columns_dirty = true;
 }
-    
 
-void Waterfall::InsertLine(float *data_l, float *data_r)
+void Waterfall::InsertLine(const float *data)
 {
-    if(!quadsInitialized) return;
-    if(line==Nlines){
-        line = 0;
-        draw_line -= Nlines;
-        if(texture_phase){
-            texture_phase = false;
-            current_tex = textures[1];
-            trailing_tex = textures[0];
-        }else{
-            texture_phase = true;
-            current_tex = textures[0];
-            trailing_tex = textures[1];
+    InsertLines(&data, 1);
+}
+
+/*
+    Row j of a run of m rows in the upload buffer, pooled from the
+    Npoints dB values per channel in data to the columns.
+*/
+void Waterfall::PoolRow(const float *data, uint16_t *pixels, int j, int m)
+{
+    for(int c=0;c<Nchannels;c++){
+        PoolPoints(columns.get(), Ncols, data + c*Npoints, Npoints,
+                   pooled.get());
+        Transport::Encode(TRANSPORT_FLOAT16, pooled.get(), Ncols,
+                          &pixels[(c*m + j)*Ncols]);
+    }
+}
+
+/*
+    A run of m lines goes to the rows line .. line+m-1 of the ring, the
+    newest highest, stopping at the wrap and at the upload_rows of a
+    frame's upload region. Each line is kept at full resolution in the
+    CPU history and, once the columns are known, pooled to them in the
+    upload buffer. The run is copied to the texture with one
+    glTexSubImage3D sourced from that buffer, so the call returns
+    without waiting for the copy. The texture keeps dB, so new limits
+    rescale the lines already drawn.
+*/
+void Waterfall::InsertLines(const float * const *lines_in, int n)
+{
+    if(!quadsInitialized || paused) return;
+    // a change of columns rebuilds these in Render
+    bool direct = texture && !columns_dirty;
+    if(direct){
+        // the rows are Ncols halves and packed layer after layer
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, upload->GetBuffer());
+    }
+    while(n>0){
+        int m = Nhistory - line;
+        if(m > upload_rows) m = upload_rows;
+        if(n < m) m = n;
+        for(int j=0;j<m;j++){
+            uint16_t *row = &lines[(size_t)(line + j)*Nchannels*Npoints];
+            Transport::Encode(TRANSPORT_FLOAT16, lines_in[j],
+                              (size_t)Nchannels*Npoints, row);
+        }
+        if(direct){
+            GLintptr offset;
+            uint16_t *pixels = (uint16_t*)upload->Allocate(
+                sizeof(uint16_t)*Ncols*Nchannels*m, offset);
+            if(pixels){
+                for(int j=0;j<m;j++)
+                    PoolRow(lines_in[j], pixels, j, m);
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, line, 0,
+                    Ncols, m, Nchannels, GL_RED, GL_HALF_FLOAT,
+                    (const void*)offset);
+            }
         }
+        lines_in += m;
+        n -= m;
+        line += m;
+        // the oldest rows are overwritten once the ring is full
+        filled += m;
+        if(filled > Nhistory){
+            stale -= filled - Nhistory;
+            if(stale < 0) stale = 0;
+            filled = Nhistory;
+        }
+        if(line==Nhistory){
+            line = 0;
+            draw_line -= Nhistory;
+        }
+    }
+    if(direct){
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
     }
-    for(int i=0;i<Npoints;i++){
-        pixels[i].r = dB2intensity(data_l[i]);
-        pixels[i].g = dB2intensity(data_r[i]);
+}
+
+/*
+    After a change of columns the oldest stale rows of the texture
+    don't match them. They are pooled again from the CPU history,
+    newest first: every row on screen straight away and up to
+    WATERFALL_REBUILD_ROWS more each frame, so a zoom or resize doesn't
+    redo a long history in one frame.
+*/
+void Waterfall::RebuildRows(void)
+{
+    int visible = (int)ceilf(Nlines*view_height) + 1;
+    int want = filled - stale + WATERFALL_REBUILD_ROWS;
+    if(want < scroll + visible) want = scroll + visible;
+    if(want > filled) want = filled;
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, upload->GetBuffer());
+    while(filled - stale < want){
+        // the newest stale row, and the run back from it to row 0
+        int age = filled - stale;
+        int top = line - 1 - age;
+        if(top < 0) top += Nhistory;
+        int m = want - age;
+        if(m > top + 1) m = top + 1;
+        if(m > upload_rows) m = upload_rows;
+        int row = top - m + 1;
+        GLintptr offset;
+        uint16_t *pixels = (uint16_t*)upload->Allocate(
+            sizeof(uint16_t)*Ncols*Nchannels*m, offset);
+        if(!pixels)
+            break;
+        for(int j=0;j<m;j++){
+            Transport::Decode(TRANSPORT_FLOAT16,
+                              &lines[(size_t)(row + j)*Nchannels*Npoints],
+                              (size_t)Nchannels*Npoints, 0, decoded.get());
+            PoolRow(decoded.get(), pixels, j, m);
+        }
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, row, 0,
+            Ncols, m, Nchannels, GL_RED, GL_HALF_FLOAT, (const void*)offset);
+        stale -= m;
     }
-    glBindTexture(GL_TEXTURE_2D, current_tex);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, Nlines-line-1, Npoints, 1, GL_RG, GL_UNSIGNED_BYTE, pixels.get());
-    line++;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+void Waterfall::SetPaused(bool paused)
+{
+    Waterfall::paused = paused;
+    // back to the newest line, without catching up through the pause
+    scroll = 0;
+    draw_line = line;
 }
-        
 
-void Waterfall::Render(glm::vec4 &color_l, glm::vec4 &color_r)
+void Waterfall::Scroll(int n)
+{
+    if(!paused) return;
+    int scroll_max = filled - (int)(Nlines*view_height);
+    if(scroll_max < 0) scroll_max = 0;
+    scroll += n;
+    if(scroll > scroll_max) scroll = scroll_max;
+    if(scroll < 0) scroll = 0;
+}
+
+void Waterfall::Render(const glm::vec4 *colors)
 {
     if(!quadsInitialized) return;
 
+    if(columns_dirty){
+        columns_dirty = false;
+        if(Ncols != Ntex)
+            CreateTexture();
+        InitializeBuffers();
+        stale = filled;
+    }
+    if(!texture) return;
+    if(stale > 0)
+        RebuildRows();
+
     float delta = line - draw_line;
     //std::cout << ".";
-    if(delta>=0.0f){
+    if(paused){
+        draw_line = line - scroll;
+    }else if(delta>=0.0f){
         if(delta>threshold){
             draw_line += delta - threshold;
             //std::cout << "+ delta:" << delta;
@@ -375,31 +503,37 @@ void Waterfall::Render(glm::vec4 &color_l, glm::vec4 &color_r)
     //std::cout << std::endl;
 
     float top = 0.0;
-    float bottom = -view_height;
+    float bottom = -1.0;
     float left = 0.0;
     float right = view_width;
     
-    glm::mat4 M_proj = glm::ortho(left, right, bottom, top);
-    glm::vec3 v_trans(0.0f, -draw_line/Nlines, 0.0f);
-    draw_line += lines_per_frame;
-    glm::mat4 M_trans = glm::translate(v_trans);
-    glm::mat4 M_mvp = M_proj*M_trans;
+    // the quad stays put, the rows move under it
+    glm::mat4 M_mvp = glm::ortho(left, right, bottom, top);
+    float head = draw_line/Nhistory;
+    float span = view_height*Nlines/Nhistory;
+    if(span > 1.0f) span = 1.0f;
+    if(!paused)
+        draw_line += lines_per_frame;
     glUseProgram(program);
     glUniform1i(s_texture_loc, 0);
     glUniformMatrix4fv(mvp_loc, 1, GL_FALSE, glm::value_ptr(M_mvp));
-    glUniform4fv(color_l_loc, 1, glm::value_ptr(color_l));
-    glUniform4fv(color_r_loc, 1, glm::value_ptr(color_r));
+    glUniform4fv(colors_loc, Nchannels, glm::value_ptr(colors[0]));
+    glUniform1i(n_channels_loc, Nchannels);
+    glUniform1f(dB_min_loc, dB_min);
+    glUniform1f(dB_scale_loc, dB_max > dB_min ? 1.0f/(dB_max - dB_min) : 0.0f);
+    glUniform1f(head_loc, head);
+    glUniform1f(span_loc, span);
  
     glActiveTexture(GL_TEXTURE0);
     
-    glBindVertexArray(vaos[0]);
-    glBindTexture(GL_TEXTURE_2D, current_tex);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, Npoints*2);
-    
-    glBindVertexArray(vaos[1]);
-    glBindTexture(GL_TEXTURE_2D, trailing_tex);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, Npoints*2);
+    glBindVertexArray(vao);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, Ncols*2);
     
     glUseProgram(0);
     glBindVertexArray(0);
+
+    // fence this frame's uploads and move on to the next region
+    upload->EndFrame();
+    upload->BeginFrame();
 }
@@ -32,21 +32,49 @@
 #include <glad/gl.h>
 #include <glm/glm.hpp>
 #include <memory>
+#include <stdint.h>
+#include "StreamBuffer.h"
+#include "PointMap.h"
 
-struct wPixel
-{
-    unsigned char r;
-    unsigned char g;
-};
+// layers of the line textures, the size of the colors uniform
+#define WATERFALL_MAX_CHANNELS 8
+// seconds of history kept by default
+#define WATERFALL_HISTORY_DEFAULT 10.0f
+// the most memory the full resolution history may take, in bytes
+#define WATERFALL_MEMORY_MAX (64*1024*1024)
+// rows pooled again each frame after the columns change
+#define WATERFALL_REBUILD_ROWS 256
+// rows not yet written, below any dB limit
+#define WATERFALL_DB_EMPTY (-1000.0f)
+// fewest rows per channel the upload buffer takes in a frame
+#define WATERFALL_UPLOAD_ROWS 16
+
+/*
+    The history is one ring of rows per channel in a 2D array texture,
+    Nhistory rows deep, written at a cursor that wraps. The screen shows
+    the newest Nlines of it. The fragment shader finds its row with
+    fract() from the position of the newest line, so nothing moves in
+    the texture and one quad covers the pane. While paused no lines are
+    written and the view can be scrolled back through the history.
 
+    The texture is as wide as the plot, one texel per point of the
+    spectrum's point map, each the peak of its bins. The lines are also
+    kept at full resolution on the CPU, so that when the map changes
+    with a zoom, resize or scale the texture is rebuilt from them.
+*/
 class Waterfall
 {
 private:
     bool quadsInitialized;
     int  Npoints;
+    int  Nchannels;
     int  Nlines;
-    bool texture_phase;
+    int  Nhistory;
+    // the next row written, how many rows hold lines, and how many of
+    // the oldest of those were pooled to other columns
     int  line;
+    int  filled;
+    int  stale;
     float draw_line;
     float lines_per_frame;
     float threshold;
@@ -54,47 +82,76 @@ private:
     float view_height;
     float dB_min;
     float dB_max;
-    std::unique_ptr<wPixel[]> pixels;
-    GLuint textures[2];
-    GLuint current_tex;
-    GLuint trailing_tex;
+    bool paused;
+    // lines back from the newest while paused
+    int  scroll;
+    // Rows of half float dB are written straight into a persistently
+    // mapped pixel unpack buffer, layer-major as uploaded, and copied
+    // to the texture by the GPU. Each frame's region is fenced. The
+    // limits are applied when drawing.
+    std::unique_ptr<StreamBuffer> upload;
+    int upload_rows;
+    // the widest row upload has room for
+    int Nupload;
+    // Nhistory lines of Npoints half float dB per channel, row-major
+    // like the texture
+    std::unique_ptr<uint16_t[]> lines;
+    std::unique_ptr<float[]> decoded;
+    // the point map of the plot, set by SetColumns and applied by the
+    // next Render
+    std::unique_ptr<PointSpan[]> columns;
+    std::unique_ptr<float[]> column_x;
+    std::unique_ptr<float[]> pooled;
+    int  Ncols;
+    int  Ncols_max;
+    bool columns_dirty;
+    // the texture, Ntex wide
+    GLuint texture;
+    int  Ntex;
+    GLint tsize;
     GLuint x_vbo;
     GLuint tex_vbo;
-    GLuint y_vbos[2];
-    GLuint vaos[2];
+    GLuint y_vbo;
+    GLuint vao;
     GLuint program;
     GLint mvp_loc;
     GLint s_texture_loc;
-    GLint color_l_loc;
-    GLint color_r_loc;
+    GLint colors_loc;
+    GLint n_channels_loc;
+    GLint dB_min_loc;
+    GLint dB_scale_loc;
+    GLint head_loc;
+    GLint span_loc;
     void InitQuads(void);
     void DeleteQuads(void);
-    unsigned char dB2intensity(float dB);
+    void CreateTexture(void);
     void InitializeBuffers(void);
+    void PoolRow(const float *data, uint16_t *pixels, int j, int m);
+    void RebuildRows(void);
 public:
-    Waterfall(int Npoints, int Nlines, float line_rate, float frame_rate);
+    // Nlines on screen, history in seconds at line_rate lines a second
+    Waterfall(int Npoints, int Nchannels, int Nlines, float history,
+        float line_rate, float frame_rate);
     ~Waterfall();
     
-    void InitializeFrequency(bool log=false);
     void SetViewWidth(float width);
     void SetViewHeight(float height);
+    // takes effect on the whole history at the next Render
     void SetdBLimits(float dB_min, float dB_max);
-    void InsertLine(float *data_l, float *data_r);
-    void Render(glm::vec4 &color_l, glm::vec4 &color_r);
-};
-
-struct Attributes
-{
-    glm::vec2 vertex;
-    glm::vec2 texel;
-};
-
-struct Pixel
-{
-    unsigned char r;
-    unsigned char g;
-    unsigned char b;
-    unsigned char a;
+    // the n points of the plot, their bins and x positions
+    void SetColumns(const PointSpan *map, const float *x, int n);
+    // Npoints dB values per channel, channel-major
+    void InsertLine(const float *data);
+    // n lines, oldest first, uploaded with one call per run up to a wrap
+    void InsertLines(const float * const *lines, int n);
+    // stop writing lines and hold the view; resuming returns to the newest
+    void SetPaused(bool paused);
+    bool GetPaused(void) { return paused; }
+    // move the paused view by n lines, positive back in time
+    void Scroll(int n);
+    int GetHistoryLines(void) { return Nhistory; }
+    // one color per channel
+    void Render(const glm::vec4 *colors);
 };
 
 
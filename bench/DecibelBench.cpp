@@ -0,0 +1,108 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  ==============================================================================
+
+    DecibelBench.cpp
+
+    Power to dB throughput of each kernel and of the log10f reference,
+    for the bin counts Nfft/2+1 of every FFT size.
+
+  ==============================================================================
+*/
+
+#include "../Decibel.h"
+#include <benchmark/benchmark.h>
+#include <math.h>
+#include <vector>
+
+// 257 to 32769, the FFT sizes 512 to 65536
+static void bin_counts(benchmark::internal::Benchmark *b)
+{
+    for(int N=512;N<=65536;N<<=1)
+        b->Arg(N/2 + 1);
+}
+
+static std::vector<float> powers(size_t n)
+{
+    std::vector<float> P(n);
+    for(size_t i=0;i<n;i++)
+        P[i] = powf(10.0f, -12.0f + 12.0f*(float)i/n);
+    return P;
+}
+
+static void BM_PowerTodB(benchmark::State &state, DecibelKernel kernel)
+{
+    if(!Decibel::SetKernel(kernel)){
+        state.SkipWithError("kernel not available here");
+        return;
+    }
+    const size_t n = state.range(0);
+    std::vector<float> P = powers(n), dB(n);
+    for(auto _ : state){
+        Decibel::PowerTodB(P.data(), dB.data(), n, 0.5f);
+        benchmark::DoNotOptimize(dB.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations()*n);
+    Decibel::SetKernel(DECIBEL_AUTO);
+}
+
+static void BM_ComplexTodB(benchmark::State &state, DecibelKernel kernel)
+{
+    if(!Decibel::SetKernel(kernel)){
+        state.SkipWithError("kernel not available here");
+        return;
+    }
+    const size_t n = state.range(0);
+    std::vector<float> X = powers(2*n), dB(n);
+    for(auto _ : state){
+        Decibel::ComplexTodB(X.data(), dB.data(), n, 0.5f);
+        benchmark::DoNotOptimize(dB.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations()*n);
+    Decibel::SetKernel(DECIBEL_AUTO);
+}
+
+static void BM_PowerTodBReference(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    std::vector<float> P = powers(n), dB(n);
+    for(auto _ : state){
+        Decibel::PowerTodBReference(P.data(), dB.data(), n, 0.5f);
+        benchmark::DoNotOptimize(dB.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations()*n);
+}
+
+BENCHMARK(BM_PowerTodBReference)->Apply(bin_counts);
+BENCHMARK_CAPTURE(BM_PowerTodB, scalar, DECIBEL_SCALAR)->Apply(bin_counts);
+#if defined(__x86_64__) || defined(__i386__)
+BENCHMARK_CAPTURE(BM_PowerTodB, sse2, DECIBEL_SSE2)->Apply(bin_counts);
+BENCHMARK_CAPTURE(BM_PowerTodB, avx2, DECIBEL_AVX2)->Apply(bin_counts);
+BENCHMARK_CAPTURE(BM_ComplexTodB, sse2, DECIBEL_SSE2)->Apply(bin_counts);
+BENCHMARK_CAPTURE(BM_ComplexTodB, avx2, DECIBEL_AVX2)->Apply(bin_counts);
+#elif defined(__aarch64__)
+BENCHMARK_CAPTURE(BM_PowerTodB, neon, DECIBEL_NEON)->Apply(bin_counts);
+BENCHMARK_CAPTURE(BM_ComplexTodB, neon, DECIBEL_NEON)->Apply(bin_counts);
+#endif
+BENCHMARK_CAPTURE(BM_ComplexTodB, scalar, DECIBEL_SCALAR)->Apply(bin_counts);
@@ -0,0 +1,106 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  ==============================================================================
+
+    FFTBench.cpp
+
+    Per-frame cost of the analysis in single and double precision: the
+    window, a measured r2c plan on SIMD aligned buffers, and the dB
+    conversion. The sizes are rate/10 for 44.1, 48 and 96 kHz, which is
+    what the UI used before the sizes became powers of two, and the two
+    power of two sizes around them.
+
+  ==============================================================================
+*/
+
+#include "../FFTWindow.h"
+#include "../Decibel.h"
+#include <benchmark/benchmark.h>
+#include <fftw3.h>
+#include <math.h>
+#include <vector>
+
+static void frame_sizes(benchmark::internal::Benchmark *b)
+{
+    for(int N : {4096, 4410, 4800, 8192, 9600})
+        b->Arg(N);
+}
+
+static void input(std::vector<float> &x)
+{
+    for(size_t i=0;i<x.size();i++)
+        x[i] = 0.5f*sinf(0.01f*i) + 1e-3f*cosf(0.37f*i);
+}
+
+static void BM_FrameFloat(benchmark::State &state)
+{
+    const int N = state.range(0);
+    const int Npoints = N/2 + 1;
+    FFTWindow window(WINDOW_DEFAULT, N);
+    std::vector<float> x(N), dB(Npoints);
+    input(x);
+    float *x_f = fftwf_alloc_real(N);
+    fftwf_complex *X_f = fftwf_alloc_complex(Npoints);
+    fftwf_plan plan = fftwf_plan_dft_r2c_1d(N, x_f, X_f, FFTW_MEASURE);
+    for(auto _ : state){
+        window.Apply(x.data(), x_f);
+        fftwf_execute(plan);
+        Decibel::ComplexTodB((const float*)X_f, dB.data(), Npoints, 1.0f);
+        benchmark::DoNotOptimize(dB.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+    fftwf_destroy_plan(plan);
+    fftwf_free(x_f);
+    fftwf_free(X_f);
+}
+
+static void BM_FrameDouble(benchmark::State &state)
+{
+    const int N = state.range(0);
+    const int Npoints = N/2 + 1;
+    FFTWindow window(WINDOW_DEFAULT, N);
+    std::vector<float> x(N), dB(Npoints);
+    input(x);
+    double *x_d = fftw_alloc_real(N);
+    fftw_complex *X_d = fftw_alloc_complex(Npoints);
+    fftw_plan plan = fftw_plan_dft_r2c_1d(N, x_d, X_d, FFTW_MEASURE);
+    for(auto _ : state){
+        window.Apply(x.data(), x_d);
+        fftw_execute(plan);
+        // as FFT::DecibelSpectrum, the power in double and dB in float
+        for(int k=0;k<Npoints;k++){
+            double re = X_d[k][0];
+            double im = X_d[k][1];
+            dB[k] = (float)(re*re + im*im);
+        }
+        Decibel::PowerTodB(dB.data(), dB.data(), Npoints, 1.0f);
+        benchmark::DoNotOptimize(dB.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+    fftw_destroy_plan(plan);
+    fftw_free(x_d);
+    fftw_free(X_d);
+}
+
+BENCHMARK(BM_FrameFloat)->Apply(frame_sizes);
+BENCHMARK(BM_FrameDouble)->Apply(frame_sizes);
@@ -0,0 +1,105 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  ==============================================================================
+
+    FFTWisdomTest.cpp
+
+    Plans missing from the wisdom cache are measured by SignalViewWisdom
+    in its own process, so planning in this one is never held up by a
+    measurement, and the measured plans are found next time.
+
+  ==============================================================================
+*/
+
+#include "../FFT.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+#include <stdlib.h>
+
+// an estimated plan takes microseconds, a measured one seconds
+#define WISDOM_PROMPT_SECONDS   1.0
+#define WISDOM_WAIT_SECONDS     60.0
+
+class FFTWisdomTest : public testing::Test
+{
+protected:
+    static std::string cache;
+    static std::string cache_last;
+    static bool cache_was_set;
+
+    // an empty cache, so that every shape starts as a miss
+    static void SetUpTestSuite()
+    {
+        char dir[] = "/tmp/SignalViewWisdomTest.XXXXXX";
+        ASSERT_NE(mkdtemp(dir), nullptr);
+        cache = dir;
+        const char *xdg = getenv("XDG_CACHE_HOME");
+        cache_was_set = xdg!=nullptr;
+        cache_last = xdg ? xdg : "";
+        setenv("XDG_CACHE_HOME", dir, 1);
+        FFT::SetWisdomTool(WISDOM_TOOL_DIR);
+    }
+
+    static void TearDownTestSuite()
+    {
+        FFT::SetWisdomTool(nullptr);
+        if(cache_was_set)
+            setenv("XDG_CACHE_HOME", cache_last.c_str(), 1);
+        else
+            unsetenv("XDG_CACHE_HOME");
+        std::filesystem::remove_all(cache);
+    }
+};
+
+std::string FFTWisdomTest::cache;
+std::string FFTWisdomTest::cache_last;
+bool FFTWisdomTest::cache_was_set;
+
+TEST_F(FFTWisdomTest, MeasuringDoesNotHoldUpPlanning)
+{
+    FFT measuring(FFT_SIZE_MAX, 2);
+    EXPECT_FALSE(measuring.GetWisdomHit());
+
+    auto t0 = std::chrono::steady_clock::now();
+    FFT next(FFT_SIZE_MAX/2, 2);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - t0;
+    EXPECT_FALSE(next.GetWisdomHit());
+    EXPECT_LT(elapsed.count(), WISDOM_PROMPT_SECONDS);
+}
+
+// a measurement still running from another test delays this one's
+TEST_F(FFTWisdomTest, MeasuredPlansAreFoundNextTime)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    bool hit = false;
+    while(!hit){
+        std::chrono::duration<double> waited = std::chrono::steady_clock::now() - t0;
+        if(waited.count() > WISDOM_WAIT_SECONDS)
+            break;
+        FFT fft(FFT_SIZE_DEFAULT, 2);
+        hit = fft.GetWisdomHit();
+        if(!hit)
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    EXPECT_TRUE(hit);
+}
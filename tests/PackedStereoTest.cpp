@@ -0,0 +1,166 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  ==============================================================================
+
+    PackedStereoTest.cpp
+
+    The STEREO_PACKED path, one complex FFT per channel pair split by
+    conjugate symmetry, against two real FFTs of the same frames.
+
+  ==============================================================================
+*/
+
+#include "../FFT.h"
+#include "../FFTWindow.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <string>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+// a full scale tone in one channel may leak into the other at most this
+// far below its peak; float rounding alone is around -160 dB
+#define PACKED_LEAKAGE_MAX_DB -120.0
+// largest difference from the two-FFT power, relative to the peak
+#define PACKED_ERROR_MAX 1e-6
+
+static void tone(float *x, int N, double cycles, float amplitude)
+{
+    for(int i=0;i<N;i++)
+        x[i] = amplitude*(float)sin(2.0*M_PI*cycles*i/N);
+}
+
+static double peak(const float *P, int n)
+{
+    double m = 0.0;
+    for(int i=0;i<n;i++)
+        if(P[i] > m) m = P[i];
+    return m;
+}
+
+class PackedStereoTest : public testing::TestWithParam<int>
+{
+protected:
+    static std::string cache;
+    static std::string cache_last;
+    static bool cache_was_set;
+
+    // the wisdom the FFTs read goes to a cache of the suite's own, and
+    // no wisdom tool is set so nothing is measured behind the tests
+    static void SetUpTestSuite()
+    {
+        char dir[] = "/tmp/PackedStereoTest.XXXXXX";
+        ASSERT_NE(mkdtemp(dir), nullptr);
+        cache = dir;
+        const char *xdg = getenv("XDG_CACHE_HOME");
+        cache_was_set = xdg!=nullptr;
+        cache_last = xdg ? xdg : "";
+        setenv("XDG_CACHE_HOME", dir, 1);
+        FFT::SetWisdomTool(nullptr);
+    }
+
+    static void TearDownTestSuite()
+    {
+        if(cache_was_set)
+            setenv("XDG_CACHE_HOME", cache_last.c_str(), 1);
+        else
+            unsetenv("XDG_CACHE_HOME");
+        std::filesystem::remove_all(cache);
+    }
+};
+
+std::string PackedStereoTest::cache;
+std::string PackedStereoTest::cache_last;
+bool PackedStereoTest::cache_was_set;
+
+// left carries a tone, right is silent, and the other way round
+TEST_P(PackedStereoTest, LeakageBetweenChannels)
+{
+    const int N = GetParam();
+    FFT fft(N, 2, FFT_FLOAT, true);
+    FFTWindow window(WINDOW_DEFAULT, N);
+    const int Np = fft.GetNumPoints();
+    std::vector<float> x(2*N), P(2*Np);
+    for(int loud=0;loud<2;loud++){
+        for(double cycles : {1.0, 100.25, N/4 + 0.5, N/2 - 3.0}){
+            std::fill(x.begin(), x.end(), 0.0f);
+            tone(&x[loud*N], N, cycles, 1.0f);
+            fft.ExecutePairs(&window, x.data());
+            fft.PowerSpectrumPairs(P.data());
+            const double P_peak = peak(&P[loud*Np], Np);
+            const double P_leak = peak(&P[(1 - loud)*Np], Np);
+            const double leak_dB = 10.0*log10(P_leak/P_peak + 1e-30);
+            EXPECT_LT(leak_dB, PACKED_LEAKAGE_MAX_DB)
+                << "N=" << N << " channel " << loud << " cycles=" << cycles;
+        }
+    }
+}
+
+// two different signals, compared bin by bin with the real transforms
+TEST_P(PackedStereoTest, MatchesTwoRealFFTs)
+{
+    const int N = GetParam();
+    FFT fft(N, 2, FFT_FLOAT, true);
+    FFTWindow window(WINDOW_DEFAULT, N);
+    const int Np = fft.GetNumPoints();
+    std::vector<float> x(2*N), P_ref(2*Np), P(2*Np);
+    tone(&x[0], N, 37.3, 0.5f);
+    tone(&x[N], N, 811.0, 0.25f);
+    uint32_t s = 1;
+    for(int i=0;i<2*N;i++){
+        s = s*1664525u + 1013904223u;
+        x[i] += 1e-3f*((s >> 8)/16777216.0f - 0.5f);
+    }
+    fft.Execute(&window, x.data());
+    fft.PowerSpectrum(P_ref.data());
+    fft.ExecutePairs(&window, x.data());
+    fft.PowerSpectrumPairs(P.data());
+    for(int c=0;c<2;c++){
+        const double tol = PACKED_ERROR_MAX*peak(&P_ref[c*Np], Np);
+        for(int k=0;k<Np;k++)
+            ASSERT_NEAR(P[c*Np + k], P_ref[c*Np + k], tol)
+                << "N=" << N << " channel " << c << " bin " << k;
+    }
+}
+
+// an odd channel count leaves the last channel alone in its pair
+TEST_P(PackedStereoTest, OddChannelCount)
+{
+    const int N = GetParam();
+    FFT fft(N, 3, FFT_FLOAT, true);
+    FFTWindow window(WINDOW_DEFAULT, N);
+    const int Np = fft.GetNumPoints();
+    std::vector<float> x(3*N), P_ref(3*Np), P(3*Np);
+    for(int c=0;c<3;c++)
+        tone(&x[c*N], N, 10.0 + 50.0*c, 1.0f);
+    fft.Execute(&window, x.data());
+    fft.PowerSpectrum(P_ref.data());
+    fft.ExecutePairs(&window, x.data());
+    fft.PowerSpectrumPairs(P.data());
+    const double tol = PACKED_ERROR_MAX*peak(P_ref.data(), 3*Np);
+    for(int k=0;k<3*Np;k++)
+        ASSERT_NEAR(P[k], P_ref[k], tol) << "N=" << N << " point " << k;
+}
+
+INSTANTIATE_TEST_SUITE_P(Sizes, PackedStereoTest,
+    testing::Values(FFT_SIZE_MIN, 4096, 16384));
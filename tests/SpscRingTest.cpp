@@ -0,0 +1,168 @@
+/*
+    SignalView LV2 analysis plugin
+    Copyright (C) 2025  Timothy William Krause
+    mailto:tmkrs4482@gmail.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  ==============================================================================
+
+    SpscRingTest.cpp
+
+    The frame rings with the producer and the consumer on their own
+    threads, over millions of frames: every frame arrives once, in
+    order, and a buffer is not reused while the consumer still reads it.
+
+  ==============================================================================
+*/
+
+#include "../SpscRing.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#define STRESS_FRAMES (1u << 22)
+
+TEST(SpscRing, RoundsCapacityUp)
+{
+    SpscRing<int> ring(5);
+    EXPECT_EQ(ring.GetCapacity(), 8u);
+    for(int i=0;i<8;i++)
+        EXPECT_TRUE(ring.Push(i));
+    EXPECT_FALSE(ring.Push(8));
+    EXPECT_EQ(ring.GetNumReady(), 8u);
+    int v;
+    for(int i=0;i<8;i++){
+        ASSERT_TRUE(ring.Pop(v));
+        EXPECT_EQ(v, i);
+    }
+    EXPECT_FALSE(ring.Pop(v));
+}
+
+TEST(SpscRing, PeekThenAdvance)
+{
+    SpscRing<int> ring(4);
+    for(int i=0;i<3;i++)
+        ring.Push(i);
+    int v;
+    ASSERT_TRUE(ring.Peek(2, v));
+    EXPECT_EQ(v, 2);
+    EXPECT_FALSE(ring.Peek(3, v));
+    ring.Advance(2);
+    ASSERT_TRUE(ring.Pop(v));
+    EXPECT_EQ(v, 2);
+    EXPECT_EQ(ring.GetNumReady(), 0u);
+}
+
+// one producer and one consumer popping one frame at a time
+TEST(SpscRing, StressPop)
+{
+    SpscRing<FrameDesc> ring(16);
+    std::thread producer([&ring](){
+        for(uint64_t s=0;s<STRESS_FRAMES;s++){
+            FrameDesc frame;
+            frame.index = (int)(s & 0xff);
+            frame.flags = (uint32_t)(s >> 8);
+            frame.timestamp = s*441;
+            frame.sequence = s;
+            while(!ring.Push(frame))
+                std::this_thread::yield();
+        }
+    });
+
+    uint64_t expected = 0;
+    uint64_t errors = 0;
+    while(expected < STRESS_FRAMES){
+        FrameDesc frame;
+        if(!ring.Pop(frame)){
+            std::this_thread::yield();
+            continue;
+        }
+        if(frame.sequence!=expected || frame.index!=(int)(expected & 0xff)
+        || frame.flags!=(uint32_t)(expected >> 8)
+        || frame.timestamp!=expected*441)
+            errors++;
+        expected++;
+    }
+    producer.join();
+    EXPECT_EQ(errors, 0u);
+    EXPECT_EQ(expected, (uint64_t)STRESS_FRAMES);
+    EXPECT_EQ(ring.GetNumReady(), 0u);
+}
+
+/*
+    The capture pattern of Spectrum: the producer fills one of capacity+1
+    buffers, only while the ring has room, and pushes its index. The
+    consumer reads batches with Peek and releases them with Advance, so
+    a buffer that is overwritten too early shows up as a mixed payload.
+*/
+TEST(SpscRing, StressPeekAdvanceBuffers)
+{
+    const size_t capacity = 8;
+    const size_t words = 16;
+    SpscRing<FrameDesc> ring(capacity);
+    const size_t n_buffers = ring.GetCapacity() + 1;
+    std::vector<uint64_t> buffers(n_buffers*words);
+
+    std::thread producer([&](){
+        size_t i_buffer = 0;
+        for(uint64_t s=0;s<STRESS_FRAMES;){
+            if(ring.GetNumReady() >= ring.GetCapacity()){
+                std::this_thread::yield();
+                continue;
+            }
+            uint64_t *buffer = &buffers[i_buffer*words];
+            for(size_t k=0;k<words;k++)
+                buffer[k] = s;
+            FrameDesc frame;
+            frame.index = (int)i_buffer;
+            frame.flags = 0;
+            frame.timestamp = s;
+            frame.sequence = s;
+            EXPECT_TRUE(ring.Push(frame));
+            s++;
+            if(++i_buffer==n_buffers)
+                i_buffer = 0;
+        }
+    });
+
+    uint64_t expected = 0;
+    uint64_t errors = 0;
+    while(expected < STRESS_FRAMES){
+        size_t n = 0;
+        FrameDesc frame;
+        // batches of up to 5, so that they straddle the wrap
+        while(n < 5 && ring.Peek(n, frame)){
+            const uint64_t *buffer = &buffers[(size_t)frame.index*words];
+            if(frame.sequence!=expected + n)
+                errors++;
+            for(size_t k=0;k<words;k++)
+                if(buffer[k]!=frame.sequence)
+                    errors++;
+            n++;
+        }
+        if(n==0){
+            std::this_thread::yield();
+            continue;
+        }
+        ring.Advance(n);
+        expected += n;
+    }
+    producer.join();
+    EXPECT_EQ(errors, 0u);
+    EXPECT_EQ(expected, (uint64_t)STRESS_FRAMES);
+    EXPECT_EQ(ring.GetNumReady(), 0u);
+}
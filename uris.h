@@ -4,10 +4,27 @@
 #include <lv2/atom/atom.h>
 #include <lv2/parameters/parameters.h>
 #include <lv2/urid/urid.h>
+#include <string.h>
 
 #define SIGNAL_VIEW_URI "https://twkrause.ca/plugins/SignalView"
 #define SIGNAL_VIEW_UI_URI SIGNAL_VIEW_URI "#ui"
 
+// channel count variants, SIGNAL_VIEW_URI is stereo
+#define SIGNAL_VIEW_MONO_URI SIGNAL_VIEW_URI "Mono"
+#define SIGNAL_VIEW_51_URI   SIGNAL_VIEW_URI "51"
+#define SIGNAL_VIEW_71_URI   SIGNAL_VIEW_URI "71"
+#define SIGNAL_VIEW_MAX_CHANNELS 8
+
+// number of audio channels of a plugin variant, 0 if unknown
+static inline int signal_view_channels(const char* uri)
+{
+    if(!strcmp(uri, SIGNAL_VIEW_MONO_URI)) return 1;
+    if(!strcmp(uri, SIGNAL_VIEW_URI))      return 2;
+    if(!strcmp(uri, SIGNAL_VIEW_51_URI))   return 6;
+    if(!strcmp(uri, SIGNAL_VIEW_71_URI))   return 8;
+    return 0;
+}
+
 struct SignalViewURIs
 {
     // URIs defined in LV2 specifications
@@ -15,6 +32,9 @@ struct SignalViewURIs
     LV2_URID atom_Bool;
     LV2_URID atom_Float;
     LV2_URID atom_Int;
+    LV2_URID atom_Long;
+    LV2_URID atom_Chunk;
+    LV2_URID atom_String;
     LV2_URID atom_eventTransfer;
     LV2_URID param_sampleRate;
 
@@ -25,14 +45,29 @@ struct SignalViewURIs
     LV2_URID RawAudio;
     LV2_URID nChannels;
     LV2_URID audioData;
+    LV2_URID sampleCount;
+    LV2_URID audioFormat;
+    LV2_URID blockExponent;
+    LV2_URID Spectra;
+    LV2_URID nPoints;
+    LV2_URID spectraData;
+    LV2_URID envelopeData;
+    LV2_URID ShmRing;
+    LV2_URID shmName;
     LV2_URID ui_On;
     LV2_URID ui_Off;
     LV2_URID ui_SendState;
     LV2_URID ui_State;
+    LV2_URID ui_ShmAck;
     LV2_URID ui_dB_min;
     LV2_URID ui_dB_max;
     LV2_URID ui_log;
     LV2_URID ui_linFreq;
+    LV2_URID ui_window;
+    LV2_URID ui_fftSize;
+    LV2_URID ui_overlap;
+    LV2_URID ui_dspAnalysis;
+    LV2_URID ui_transport;
 
     SignalViewURIs(LV2_URID_Map* map)
     {
@@ -40,6 +75,9 @@ struct SignalViewURIs
         atom_Bool          = map->map(map->handle, LV2_ATOM__Bool);
         atom_Float         = map->map(map->handle, LV2_ATOM__Float);
         atom_Int           = map->map(map->handle, LV2_ATOM__Int);
+        atom_Long          = map->map(map->handle, LV2_ATOM__Long);
+        atom_Chunk         = map->map(map->handle, LV2_ATOM__Chunk);
+        atom_String        = map->map(map->handle, LV2_ATOM__String);
         atom_eventTransfer = map->map(map->handle, LV2_ATOM__eventTransfer);
         param_sampleRate   = map->map(map->handle, LV2_PARAMETERS__sampleRate);
 
@@ -49,14 +87,29 @@ struct SignalViewURIs
         RawAudio     = map->map(map->handle, SIGNAL_VIEW_URI "#RawAudio");
         audioData    = map->map(map->handle, SIGNAL_VIEW_URI "#audioData");
         nChannels    = map->map(map->handle, SIGNAL_VIEW_URI "#nChannels");
+        sampleCount  = map->map(map->handle, SIGNAL_VIEW_URI "#sampleCount");
+        audioFormat  = map->map(map->handle, SIGNAL_VIEW_URI "#audioFormat");
+        blockExponent = map->map(map->handle, SIGNAL_VIEW_URI "#blockExponent");
+        Spectra      = map->map(map->handle, SIGNAL_VIEW_URI "#Spectra");
+        nPoints      = map->map(map->handle, SIGNAL_VIEW_URI "#nPoints");
+        spectraData  = map->map(map->handle, SIGNAL_VIEW_URI "#spectraData");
+        envelopeData = map->map(map->handle, SIGNAL_VIEW_URI "#envelopeData");
+        ShmRing      = map->map(map->handle, SIGNAL_VIEW_URI "#ShmRing");
+        shmName      = map->map(map->handle, SIGNAL_VIEW_URI "#shmName");
         ui_On        = map->map(map->handle, SIGNAL_VIEW_URI "#UIOn");
         ui_Off       = map->map(map->handle, SIGNAL_VIEW_URI "#UIOff");
         ui_SendState = map->map(map->handle, SIGNAL_VIEW_URI "#UISendState");
         ui_State     = map->map(map->handle, SIGNAL_VIEW_URI "#UIState");
+        ui_ShmAck    = map->map(map->handle, SIGNAL_VIEW_URI "#UIShmAck");
         ui_dB_min    = map->map(map->handle, SIGNAL_VIEW_URI "#ui-dB-min");
         ui_dB_max    = map->map(map->handle, SIGNAL_VIEW_URI "#ui-dB-max");
         ui_log       = map->map(map->handle, SIGNAL_VIEW_URI "#ui-log");
         ui_linFreq   = map->map(map->handle, SIGNAL_VIEW_URI "#ui-linFreq");
+        ui_window    = map->map(map->handle, SIGNAL_VIEW_URI "#ui-window");
+        ui_fftSize   = map->map(map->handle, SIGNAL_VIEW_URI "#ui-fftSize");
+        ui_overlap   = map->map(map->handle, SIGNAL_VIEW_URI "#ui-overlap");
+        ui_dspAnalysis = map->map(map->handle, SIGNAL_VIEW_URI "#ui-dspAnalysis");
+        ui_transport = map->map(map->handle, SIGNAL_VIEW_URI "#ui-transport");
     }
 
 };